@@ -0,0 +1,313 @@
+// AsyncLogger.cpp
+
+#include "AsyncLogger.h"
+#include "EventLog.h"
+#include <charconv>
+#include <chrono>
+#include <cstring>
+
+// the writer flushes its buffer to the stream once it grows past this
+const size_t WRITE_BATCH_BYTES = 256 * 1024;
+// records the writer pops before checking the buffer size
+const int POP_BATCH = 1024;
+
+// dotted quad -> 32 bits, without the allocations of IPBlocker::parseIp
+static uint32_t packIp(const std::string& ip) {
+    uint32_t value = 0;
+    uint32_t octet = 0;
+    for (int i = 0; i < (int)ip.size(); i++) {
+        if (ip[i] == '.') {
+            value = (value << 8) | (octet & 0xFF);
+            octet = 0;
+        } else {
+            octet = octet * 10 + (ip[i] - '0');
+        }
+    }
+    return (value << 8) | (octet & 0xFF);
+}
+
+// digits straight onto the end of out, as LogBuffer does
+static void appendNumber(long long value, std::string& out) {
+    char digits[24];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr - digits);
+}
+
+// 32 bits -> dotted quad
+static void appendIp(uint32_t ip, std::string& out) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        appendNumber((ip >> shift) & 0xFF, out);
+        if (shift > 0) {
+            out += '.';
+        }
+    }
+}
+
+// start the writer straight away
+AsyncLogger::AsyncLogger(std::ostream& stream, int ringSize, LogOverflow policy, EventLogEncoder* binary)
+    : ring(ringSize), out(stream), overflow(policy), encoder(binary), stopping(false) {
+    recordCount = 0;
+    dropCount = 0;
+    stallCount = 0;
+    batchCount = 0;
+    writer = std::thread(&AsyncLogger::writerLoop, this);
+}
+
+// make sure the writer is gone before the ring is
+AsyncLogger::~AsyncLogger() {
+    stop();
+}
+
+// per the overflow policy when the ring is full
+void AsyncLogger::push(const LogRecord& record) {
+    LogRecord copy = record;
+    if (ring.tryPush(copy)) {
+        recordCount++;
+        return;
+    }
+    if (overflow == LOG_OVERFLOW_DROP) {
+        dropCount++;
+        return;
+    }
+    pushWaiting(copy);
+}
+
+// split into text chunks; every chunk waits so the line stays whole
+void AsyncLogger::pushLine(std::string_view line) {
+    size_t offset = 0;
+    do {
+        LogRecord record;
+        offset = textChunk(line, offset, record);
+        pushWaiting(record);
+    } while (offset < line.size());
+}
+
+// as much of the line as one record holds
+size_t AsyncLogger::textChunk(std::string_view line, size_t offset, LogRecord& record) {
+    size_t chunk = line.size() - offset;
+    if (chunk > sizeof(record.text)) {
+        chunk = sizeof(record.text);
+    }
+    memcpy(record.text, line.data() + offset, chunk);
+    record.kind = LOG_TEXT;
+    record.length = (unsigned char)chunk;
+    offset += chunk;
+    record.more = offset < line.size() ? 1 : 0;
+    return offset;
+}
+
+// let the writer finish what is queued, then join
+void AsyncLogger::stop() {
+    if (!writer.joinable()) {
+        return;
+    }
+    stopping.store(true, std::memory_order_release);
+    writer.join();
+    out.flush();
+}
+
+// getter for records pushed
+long long AsyncLogger::records() const {
+    return recordCount;
+}
+
+// getter for records dropped
+long long AsyncLogger::dropped() const {
+    return dropCount;
+}
+
+// getter for pushes that waited
+long long AsyncLogger::stalls() const {
+    return stallCount;
+}
+
+// getter for stream writes
+long long AsyncLogger::batches() const {
+    return batchCount;
+}
+
+// fill in the fields the line for this kind prints
+LogRecord AsyncLogger::makeRecord(LogEventKind kind, int cycle, const Request& request, int value, const std::string& server) {
+    LogRecord record;
+    record.kind = (unsigned char)kind;
+    record.cycle = cycle;
+    record.jobType = request.jobType;
+    record.requestId = request.id;
+    record.value = value;
+    record.ipIn = packIp(request.ipIn);
+    record.ipOut = packIp(request.ipOut);
+    size_t length = server.size() < sizeof(record.text) ? server.size() : sizeof(record.text);
+    memcpy(record.text, server.data(), length);
+    record.length = (unsigned char)length;
+    return record;
+}
+
+// a finished request: id, response time and server
+LogRecord AsyncLogger::makeCompletion(int cycle, int requestId, int response, const std::string& server) {
+    LogRecord record;
+    record.kind = LOG_COMPLETED;
+    record.cycle = cycle;
+    record.requestId = requestId;
+    record.value = response;
+    size_t length = server.size() < sizeof(record.text) ? server.size() : sizeof(record.text);
+    memcpy(record.text, server.data(), length);
+    record.length = (unsigned char)length;
+    return record;
+}
+
+// same text the synchronous log has always written, appended with no temporary strings
+void AsyncLogger::format(const LogRecord& record, std::string& out) {
+    if (record.kind == LOG_TEXT) {
+        out.append(record.text, record.length);
+        if (!record.more) {
+            out += '\n';
+        }
+        return;
+    }
+    // the text log already has a SCALE line for this
+    if (record.kind == LOG_SCALED) {
+        return;
+    }
+
+    switch (record.kind) {
+    case LOG_QUEUED:
+        out += "[QUEUED] Request #";
+        appendNumber(record.requestId, out);
+        out += " | ";
+        appendIp(record.ipIn, out);
+        out += " -> ";
+        appendIp(record.ipOut, out);
+        out += " | type=";
+        out += record.jobType;
+        out += " time=";
+        appendNumber(record.value, out);
+        break;
+    case LOG_ASSIGNED:
+        out += "[ASSIGNED] Request #";
+        appendNumber(record.requestId, out);
+        out += " -> server ";
+        out.append(record.text, record.length);
+        out += " | ";
+        appendIp(record.ipIn, out);
+        out += " -> ";
+        appendIp(record.ipOut, out);
+        out += " | time=";
+        appendNumber(record.value, out);
+        break;
+    case LOG_SHED_FULL:
+        out += "[SHED] Request #";
+        appendNumber(record.requestId, out);
+        out += " rejected (queue full)";
+        break;
+    case LOG_SHED_EARLY:
+        out += "[SHED] Request #";
+        appendNumber(record.requestId, out);
+        out += " rejected (early drop)";
+        break;
+    case LOG_CODEL_DROP:
+        out += "[SHED] Request #";
+        appendNumber(record.requestId, out);
+        out += " dropped by CoDel after ";
+        appendNumber(record.value, out);
+        out += " cycles";
+        break;
+    case LOG_TIMEOUT:
+        out += "[TIMEOUT] Request #";
+        appendNumber(record.requestId, out);
+        out += " gave up after ";
+        appendNumber(record.value, out);
+        out += " cycles";
+        break;
+    case LOG_PREEMPTED:
+        out += "[PREEMPTED] Request #";
+        appendNumber(record.requestId, out);
+        out += " on server ";
+        out.append(record.text, record.length);
+        out += " | remaining=";
+        appendNumber(record.value, out);
+        break;
+    case LOG_COMPLETED:
+        out += "[COMPLETED] Request #";
+        appendNumber(record.requestId, out);
+        out += " on server ";
+        out.append(record.text, record.length);
+        out += " | response=";
+        appendNumber(record.value, out);
+        break;
+    case LOG_BLOCKED:
+        out += "[BLOCK] Request #";
+        appendNumber(record.requestId, out);
+        out += " BLOCKED | src=";
+        appendIp(record.ipIn, out);
+        out += " dst=";
+        appendIp(record.ipOut, out);
+        break;
+    }
+    out += '\n';
+}
+
+// config name -> log level
+bool AsyncLogger::parseLevel(const std::string& name, LogLevel& level) {
+    static const char* const NAMES[] = {"off", "error", "scale", "info", "request", "trace"};
+    for (int i = LOG_OFF; i <= LOG_TRACE; i++) {
+        if (name == NAMES[i]) {
+            level = (LogLevel)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// config name -> overflow policy
+bool AsyncLogger::parseOverflow(const std::string& name, LogOverflow& policy) {
+    if (name == "block") {
+        policy = LOG_OVERFLOW_BLOCK;
+    } else if (name == "drop") {
+        policy = LOG_OVERFLOW_DROP;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// format everything available, write when the buffer is big or the ring is dry
+void AsyncLogger::writerLoop() {
+    std::string buffer;
+    buffer.reserve(WRITE_BATCH_BYTES + 4096);
+    LogRecord record;
+    while (true) {
+        // read the flag before popping, so an empty ring after it really is the end
+        bool finishing = stopping.load(std::memory_order_acquire);
+        int popped = 0;
+        while (popped < POP_BATCH && ring.tryPop(record)) {
+            if (encoder != nullptr) {
+                encoder->encode(record, buffer);
+            } else {
+                format(record, buffer);
+            }
+            popped++;
+        }
+        if (buffer.size() >= WRITE_BATCH_BYTES || (popped == 0 && !buffer.empty())) {
+            out.write(buffer.data(), buffer.size());
+            buffer.clear();
+            batchCount++;
+        }
+        if (popped == 0) {
+            if (finishing) {
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+// spin politely until the writer frees a slot
+void AsyncLogger::pushWaiting(LogRecord& record) {
+    if (!ring.tryPush(record)) {
+        stallCount++;
+        while (!ring.tryPush(record)) {
+            std::this_thread::yield();
+        }
+    }
+    recordCount++;
+}
@@ -0,0 +1,239 @@
+/**
+ * @file AsyncLogger.h
+ * @brief Defines log levels, the fixed-size log record and the AsyncLogger
+ *        class that formats and writes records on a background thread.
+ *
+ * @author Karan Bhagat
+ * @date 2026
+ */
+
+#ifndef ASYNCLOGGER_H
+#define ASYNCLOGGER_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "Request.h"
+#include "RingBuffer.h"
+
+class EventLogEncoder;
+
+/**
+ * @enum LogLevel
+ * @brief Log verbosity; a message is written if its level is at or below
+ *        the configured one.
+ */
+enum LogLevel {
+    LOG_OFF,     ///< Nothing.
+    LOG_ERROR,   ///< Errors only.
+    LOG_SCALE,   ///< Pool changes: scale up/down and drained servers.
+    LOG_INFO,    ///< Banner, periodic status and the summary.
+    LOG_REQUEST, ///< Per-request admission: queued, blocked, shed, timed out.
+    LOG_TRACE    ///< Per-request dispatch: assigned, preempted, completed.
+};
+
+/**
+ * @def LOG_COMPILED_LEVEL
+ * @brief Most verbose LogLevel compiled in.
+ *
+ * Per-request logging above this level is removed with @c if @c constexpr,
+ * so a build with e.g. @c -DLOG_COMPILED_LEVEL=LOG_INFO (@c make
+ * @c LOG_LEVEL=LOG_INFO) has no per-request logging code in its hot loops
+ * at all. The runtime level (Config::logLevel) can only lower it further.
+ */
+#ifndef LOG_COMPILED_LEVEL
+#define LOG_COMPILED_LEVEL LOG_TRACE
+#endif
+
+/**
+ * @enum LogEventKind
+ * @brief What a LogRecord describes; each kind renders as one log line.
+ */
+enum LogEventKind {
+    LOG_TEXT,       ///< Preformatted text (a chunk of it, see LogRecord::more).
+    LOG_QUEUED,     ///< Request admitted to a queue.
+    LOG_ASSIGNED,   ///< Request dispatched to a server.
+    LOG_SHED_FULL,  ///< Arrival rejected because the queue was full.
+    LOG_SHED_EARLY, ///< Arrival dropped early by RED.
+    LOG_CODEL_DROP, ///< Queued request dropped by CoDel.
+    LOG_TIMEOUT,    ///< Queued request whose client gave up.
+    LOG_PREEMPTED,  ///< Running request preempted under SRPT.
+    LOG_COMPLETED,  ///< Request finished on a server.
+    LOG_BLOCKED,    ///< Arrival rejected by the firewall.
+    LOG_SCALED      ///< Pool resized (binary log only; the text log has the SCALE line).
+};
+
+/**
+ * @enum LogOverflow
+ * @brief What the producer does when the AsyncLogger's ring is full.
+ */
+enum LogOverflow {
+    LOG_OVERFLOW_BLOCK, ///< Wait for the writer to make room; nothing is lost.
+    LOG_OVERFLOW_DROP   ///< Discard the record and count it.
+};
+
+/**
+ * @struct LogRecord
+ * @brief One log event in a fixed 64-byte binary form.
+ *
+ * Per-request events carry the numbers they print (IPs packed into 32
+ * bits) rather than text, so recording one is a few stores; the text is
+ * produced later by AsyncLogger::format(). Text lines are split across as
+ * many LOG_TEXT records as they need.
+ */
+struct LogRecord {
+    unsigned char kind;   ///< LogEventKind.
+    char jobType;         ///< Request job type ('P' or 'S').
+    unsigned char length; ///< Bytes of @c text in use.
+    unsigned char more;   ///< LOG_TEXT only: the line continues in the next record.
+    int cycle;            ///< Simulation cycle of the event.
+    int requestId;        ///< Request id (pool size after the change for LOG_SCALED).
+    int value;            ///< Service time, cycles waited, work remaining, response time or servers added, by kind.
+    uint32_t ipIn;        ///< Packed source IP.
+    uint32_t ipOut;       ///< Packed destination IP.
+    char text[40];        ///< Server id, or a chunk of a LOG_TEXT line (not null-terminated).
+
+    LogRecord() {
+        kind = LOG_TEXT;
+        jobType = 0;
+        length = 0;
+        more = 0;
+        cycle = 0;
+        requestId = 0;
+        value = 0;
+        ipIn = 0;
+        ipOut = 0;
+    }
+};
+
+/**
+ * @class AsyncLogger
+ * @brief Moves log writing off the simulation thread.
+ *
+ * The simulation thread pushes LogRecords into a bounded SpscRing; a
+ * background writer thread pops them, formats them into a large buffer and
+ * writes the buffer to the stream in one call once it passes 256 KB or the
+ * ring runs dry. The stream belongs to the writer until stop() returns.
+ *
+ * When the ring is full, per-request records either wait for room or are
+ * dropped and counted, per LogOverflow. Text lines always wait, so a line
+ * split across records is never torn.
+ */
+class AsyncLogger {
+public:
+    /**
+     * @brief Starts the writer thread.
+     * @param out      Stream the writer formats into; not touched by the caller until stop().
+     * @param ringSize Records the ring holds (rounded up to a power of two).
+     * @param overflow What push() does when the ring is full.
+     * @param encoder  Binary encoder the writer uses instead of format(), or
+     *                 @c nullptr for the text log; used only by the writer
+     *                 thread until stop().
+     */
+    AsyncLogger(std::ostream& out, int ringSize, LogOverflow overflow, EventLogEncoder* encoder = nullptr);
+
+    /** @brief Destructor. Calls stop(). */
+    ~AsyncLogger();
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    /**
+     * @brief Hands one record to the writer (producer thread only).
+     * @param record Record to log.
+     */
+    void push(const LogRecord& record);
+
+    /**
+     * @brief Hands a text line (without its newline) to the writer,
+     *        waiting for room whatever the overflow policy.
+     * @param line Text to log.
+     */
+    void pushLine(std::string_view line);
+
+    /** @brief Lets the writer drain the ring, then joins it and flushes the stream. Idempotent. */
+    void stop();
+
+    /** @brief Records accepted into the ring. */
+    long long records() const;
+
+    /** @brief Records discarded under LOG_OVERFLOW_DROP. */
+    long long dropped() const;
+
+    /** @brief Pushes that found the ring full and had to wait. */
+    long long stalls() const;
+
+    /** @brief Buffered writes the writer made (valid after stop()). */
+    long long batches() const;
+
+    /**
+     * @brief Builds a per-request record.
+     * @param kind    LogEventKind of the event.
+     * @param cycle   Simulation cycle of the event.
+     * @param request Request it concerns.
+     * @param value   Number the line prints (see LogRecord::value).
+     * @param server  Server id for LOG_ASSIGNED and LOG_PREEMPTED, else empty.
+     */
+    static LogRecord makeRecord(LogEventKind kind, int cycle, const Request& request, int value, const std::string& server);
+
+    /**
+     * @brief Builds a LOG_COMPLETED record (only the id survives on the server).
+     * @param cycle     Simulation cycle the request finished in.
+     * @param requestId Request id.
+     * @param response  Enqueue-to-completion time, in cycles.
+     * @param server    Id of the server that ran it.
+     */
+    static LogRecord makeCompletion(int cycle, int requestId, int response, const std::string& server);
+
+    /**
+     * @brief Fills @p record with the LOG_TEXT chunk of @p line starting at @p offset.
+     * @return Offset just past the chunk; the line is done once it reaches line.size().
+     */
+    static size_t textChunk(std::string_view line, size_t offset, LogRecord& record);
+
+    /**
+     * @brief Appends the text form of @p record to @p out; the newline
+     *        is added unless it is a LOG_TEXT chunk with more to follow.
+     */
+    static void format(const LogRecord& record, std::string& out);
+
+    /**
+     * @brief Parses a log level name from the config file.
+     * @param name  One of @c off, @c error, @c scale, @c info, @c request, @c trace.
+     * @param level Output parameter set on success.
+     * @return @c true if @p name was recognised.
+     */
+    static bool parseLevel(const std::string& name, LogLevel& level);
+
+    /**
+     * @brief Parses an overflow policy name from the config file.
+     * @param name     @c block or @c drop.
+     * @param overflow Output parameter set on success.
+     * @return @c true if @p name was recognised.
+     */
+    static bool parseOverflow(const std::string& name, LogOverflow& overflow);
+
+private:
+    /** @brief Writer thread: pop, format, write in batches until stopped and empty. */
+    void writerLoop();
+
+    /** @brief Pushes one record, waiting while the ring is full. */
+    void pushWaiting(LogRecord& record);
+
+    SpscRing<LogRecord> ring;      ///< Records in flight to the writer.
+    std::ostream& out;             ///< Destination stream.
+    LogOverflow overflow;          ///< Full-ring behaviour for push().
+    EventLogEncoder* encoder;      ///< Binary encoder, or @c nullptr for text (not owned).
+    std::thread writer;            ///< Background formatting/writing thread.
+    std::atomic<bool> stopping;    ///< Set by stop(); the writer exits once the ring is empty.
+    long long recordCount;         ///< Records pushed (producer side).
+    long long dropCount;           ///< Records dropped (producer side).
+    long long stallCount;          ///< Pushes that waited (producer side).
+    long long batchCount;          ///< Stream writes (writer side).
+};
+
+#endif
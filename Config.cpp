@@ -1,6 +1,7 @@
 // Config.cpp
 
 #include "Config.h"
+#include "FairQueue.h"
 #include <cstdlib>
 #include <fstream>
 #include <sstream>
@@ -27,6 +28,47 @@ static void parseBlockedRanges(const std::string& value, std::vector<std::string
     }
 }
 
+// parses "name:speed:count" entries separated by commas
+static void parseServerTypes(const std::string& value, std::vector<ServerType>& types) {
+    std::stringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        item = trim(item);
+        int first = (int)item.find(':');
+        int second = first == -1 ? -1 : (int)item.find(':', first + 1);
+        if (second == -1) {
+            continue;
+        }
+
+        ServerType type;
+        type.name = trim(item.substr(0, first));
+        type.speed = atof(item.substr(first + 1, second - first - 1).c_str());
+        type.count = atoi(item.substr(second + 1).c_str());
+        if (!type.name.empty() && type.speed > 0.0 && type.count >= 0) {
+            types.push_back(type);
+        }
+    }
+}
+
+// parses "P:weight,S:weight" into one weight per FairQueue lane
+static void parseJobTypeWeights(const std::string& value, std::vector<double>& weights) {
+    weights.assign(FairQueue::LANE_COUNT, 1.0);
+    std::stringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        item = trim(item);
+        int colon = (int)item.find(':');
+        if (colon != 1) {
+            continue;
+        }
+
+        double weight = atof(item.substr(colon + 1).c_str());
+        if (weight > 0.0) {
+            weights[FairQueue::laneFor(item[0])] = weight;
+        }
+    }
+}
+
 // reads the config file line by line and sets matching fields
 bool ConfigLoader::loadFromFile(const std::string& path, Config& config) {
     std::ifstream file(path);
@@ -67,6 +109,122 @@ bool ConfigLoader::loadFromFile(const std::string& path, Config& config) {
             config.logFilePath = val;
         } else if (key == "seed") {
             config.seed = (unsigned int)atoi(val.c_str());
+        } else if (key == "worker_threads") {
+            config.workerThreads = atoi(val.c_str());
+        } else if (key == "pipeline") {
+            config.pipelineMode = atoi(val.c_str()) != 0;
+        } else if (key == "pipeline_ring_size") {
+            config.pipelineRingSize = atoi(val.c_str());
+        } else if (key == "log_level") {
+            config.logLevel = val;
+        } else if (key == "console_level") {
+            config.consoleLevel = val;
+        } else if (key == "console_window") {
+            config.consoleWindow = atoi(val.c_str());
+        } else if (key == "console_burst") {
+            config.consoleBurst = atoi(val.c_str());
+        } else if (key == "log_format") {
+            config.logFormat = val;
+        } else if (key == "log_async") {
+            config.logAsync = atoi(val.c_str()) != 0;
+        } else if (key == "log_ring_size") {
+            config.logRingSize = atoi(val.c_str());
+        } else if (key == "log_overflow") {
+            config.logOverflow = val;
+        } else if (key == "timeseries_file") {
+            config.timeseriesFile = val;
+        } else if (key == "timeseries_format") {
+            config.timeseriesFormat = val;
+        } else if (key == "timeseries_window") {
+            config.timeseriesWindow = atoi(val.c_str());
+        } else if (key == "timeseries_max_rows") {
+            config.timeseriesMaxRows = atoi(val.c_str());
+        } else if (key == "metrics_port") {
+            config.metricsPort = atoi(val.c_str());
+        } else if (key == "metrics_interval") {
+            config.metricsInterval = atoi(val.c_str());
+        } else if (key == "server_slots") {
+            config.serverSlots = atoi(val.c_str());
+        } else if (key == "server_mode") {
+            config.serverMode = val;
+        } else if (key == "server_types") {
+            config.serverTypes.clear();
+            parseServerTypes(val, config.serverTypes);
+        } else if (key == "scale_up_type") {
+            config.scaleUpType = val;
+        } else if (key == "server_boot_cycles") {
+            config.serverBootCycles = atoi(val.c_str());
+        } else if (key == "server_warmup_cycles") {
+            config.serverWarmupCycles = atoi(val.c_str());
+        } else if (key == "warmup_speed") {
+            config.warmupSpeed = atof(val.c_str());
+        } else if (key == "dispatch_policy") {
+            config.dispatchPolicy = val;
+        } else if (key == "dispatch_choices") {
+            config.dispatchChoices = atoi(val.c_str());
+        } else if (key == "client_count") {
+            config.clientCount = atoi(val.c_str());
+        } else if (key == "cache_policy") {
+            config.cachePolicy = val;
+        } else if (key == "cache_capacity") {
+            config.cacheCapacity = atoi(val.c_str());
+        } else if (key == "cache_key") {
+            config.cacheKey = val;
+        } else if (key == "cache_hit_factor") {
+            config.cacheHitFactor = atof(val.c_str());
+        } else if (key == "content_count") {
+            config.contentCount = atoi(val.c_str());
+        } else if (key == "queue_discipline") {
+            config.queueDiscipline = val;
+        } else if (key == "queue_interval_width") {
+            config.queueIntervalWidth = atoi(val.c_str());
+        } else if (key == "job_type_weights") {
+            config.jobTypeWeights.clear();
+            if (!val.empty()) {
+                parseJobTypeWeights(val, config.jobTypeWeights);
+            }
+        } else if (key == "stream_time_multiplier") {
+            config.streamTimeMultiplier = atoi(val.c_str());
+        } else if (key == "request_timeout") {
+            config.requestTimeout = atoi(val.c_str());
+        } else if (key == "request_timeout_dist") {
+            config.requestTimeoutDist = val;
+        } else if (key == "queue_capacity") {
+            config.queueCapacity = atoi(val.c_str());
+        } else if (key == "shed_policy") {
+            config.shedPolicy = val;
+        } else if (key == "red_max_probability") {
+            config.redMaxProbability = atof(val.c_str());
+        } else if (key == "codel_target") {
+            config.codelTarget = atoi(val.c_str());
+        } else if (key == "codel_interval") {
+            config.codelInterval = atoi(val.c_str());
+        } else if (key == "scaling_policy") {
+            config.scalingPolicy = val;
+        } else if (key == "scaling_horizon") {
+            config.scalingHorizon = atoi(val.c_str());
+        } else if (key == "target_utilization") {
+            config.targetUtilization = atof(val.c_str());
+        } else if (key == "forecast_alpha") {
+            config.forecastAlpha = atof(val.c_str());
+        } else if (key == "slo_wait_p95") {
+            config.sloWaitP95 = atoi(val.c_str());
+        } else if (key == "pid_kp") {
+            config.pidKp = atof(val.c_str());
+        } else if (key == "pid_ki") {
+            config.pidKi = atof(val.c_str());
+        } else if (key == "pid_kd") {
+            config.pidKd = atof(val.c_str());
+        } else if (key == "pid_max_step") {
+            config.pidMaxStep = atoi(val.c_str());
+        } else if (key == "scale_max_step") {
+            config.scaleMaxStep = atoi(val.c_str());
+        } else if (key == "scale_down_drain") {
+            config.scaleDownDrain = atoi(val.c_str()) != 0;
+        } else if (key == "min_servers") {
+            config.minServers = atoi(val.c_str());
+        } else if (key == "max_servers") {
+            config.maxServers = atoi(val.c_str());
         } else if (key == "blocked_ranges") {
             config.blockedRanges.clear();
             parseBlockedRanges(val, config.blockedRanges);
@@ -79,6 +237,135 @@ bool ConfigLoader::loadFromFile(const std::string& path, Config& config) {
     if (config.maxRequestTime < config.minRequestTime) {
         config.maxRequestTime = config.minRequestTime;
     }
+    if (config.workerThreads < 1) {
+        config.workerThreads = 1;
+    }
+    if (config.pipelineRingSize < 2) {
+        config.pipelineRingSize = 2;
+    }
+    if (config.logFormat != "binary") {
+        config.logFormat = "text";
+    }
+    if (config.logRingSize < 2) {
+        config.logRingSize = 2;
+    }
+    if (config.timeseriesFormat != "binary") {
+        config.timeseriesFormat = "csv";
+    }
+    if (config.timeseriesWindow < 1) {
+        config.timeseriesWindow = 1;
+    }
+    if (config.timeseriesMaxRows < 1) {
+        config.timeseriesMaxRows = 1;
+    }
+    if (config.metricsPort < 0 || config.metricsPort > 65535) {
+        config.metricsPort = 0;
+    }
+    if (config.metricsInterval < 1) {
+        config.metricsInterval = 1;
+    }
+    if (config.consoleWindow < 1) {
+        config.consoleWindow = 1;
+    }
+    if (config.consoleBurst < 0) {
+        config.consoleBurst = 0;
+    }
+    if (config.serverSlots < 1) {
+        config.serverSlots = 1;
+    }
+    if (config.serverMode != "ps") {
+        config.serverMode = "fcfs";
+    }
+    if (!config.serverTypes.empty()) {
+        int total = 0;
+        for (int i = 0; i < (int)config.serverTypes.size(); i++) {
+            total += config.serverTypes[i].count;
+        }
+        if (total > 0) {
+            config.initialServers = total;
+        }
+    }
+    if (config.serverBootCycles < 0) {
+        config.serverBootCycles = 0;
+    }
+    if (config.serverWarmupCycles < 0) {
+        config.serverWarmupCycles = 0;
+    }
+    if (config.warmupSpeed <= 0.0 || config.warmupSpeed > 1.0) {
+        config.warmupSpeed = 0.5;
+    }
+    if (config.dispatchChoices < 1) {
+        config.dispatchChoices = 1;
+    }
+    if (config.clientCount < 0) {
+        config.clientCount = 0;
+    }
+    if (config.cacheCapacity < 1) {
+        config.cacheCapacity = 1;
+    }
+    if (config.cacheKey != "ip_out") {
+        config.cacheKey = "content";
+    }
+    if (config.cacheHitFactor <= 0.0 || config.cacheHitFactor > 1.0) {
+        config.cacheHitFactor = 0.2;
+    }
+    if (config.contentCount < 1) {
+        config.contentCount = 1;
+    }
+    if (config.queueIntervalWidth < 1) {
+        config.queueIntervalWidth = 1;
+    }
+    if (config.streamTimeMultiplier < 1) {
+        config.streamTimeMultiplier = 1;
+    }
+    if (config.requestTimeout < 0) {
+        config.requestTimeout = 0;
+    }
+    if (config.requestTimeoutDist != "uniform" && config.requestTimeoutDist != "exponential") {
+        config.requestTimeoutDist = "fixed";
+    }
+    if (config.queueCapacity < 0) {
+        config.queueCapacity = 0;
+    }
+    if (config.redMaxProbability < 0.0) {
+        config.redMaxProbability = 0.0;
+    }
+    if (config.redMaxProbability > 1.0) {
+        config.redMaxProbability = 1.0;
+    }
+    if (config.codelTarget < 1) {
+        config.codelTarget = 1;
+    }
+    if (config.codelInterval < 1) {
+        config.codelInterval = 1;
+    }
+    if (config.scalingHorizon < 1) {
+        config.scalingHorizon = 1;
+    }
+    if (config.targetUtilization <= 0.0 || config.targetUtilization > 1.0) {
+        config.targetUtilization = 0.8;
+    }
+    if (config.forecastAlpha <= 0.0 || config.forecastAlpha > 1.0) {
+        config.forecastAlpha = 0.01;
+    }
+    if (config.sloWaitP95 < 1) {
+        config.sloWaitP95 = 1;
+    }
+    if (config.pidMaxStep < 1) {
+        config.pidMaxStep = 1;
+    }
+    if (config.scaleMaxStep < 1) {
+        config.scaleMaxStep = 1;
+    }
+    if (config.minServers < 1) {
+        config.minServers = 1;
+    }
+    if (config.maxServers < 0) {
+        config.maxServers = 0;
+    }
+    if (config.maxServers > 0 && config.maxServers < config.minServers) {
+        config.maxServers = config.minServers;
+    }
 
     return true;
 }
\ No newline at end of file
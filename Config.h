@@ -13,6 +13,16 @@
 #include <string>
 #include <vector>
 
+/**
+ * @struct ServerType
+ * @brief One class of backend server (e.g. an instance type).
+ */
+struct ServerType {
+    std::string name; ///< Label used in server IDs and the summary.
+    double speed;     ///< Service speed relative to a baseline server (2.0 = twice as fast).
+    int count;        ///< Servers of this type in the initial pool (also its share when resized).
+};
+
 /**
  * @struct Config
  * @brief All tunable parameters for a simulation run.
@@ -31,6 +41,62 @@ struct Config {
     int statusPrintInterval;      ///< Log a status line every N cycles (0 = disabled). Default: 500.
     std::string logFilePath;      ///< Path to the output log file. Default: @c "load_balancer.log".
     unsigned int seed;            ///< RNG seed (0 = use time-based seed). Default: 0.
+    int workerThreads;            ///< Shards/threads used to tick the server pool. Default: 1.
+    bool pipelineMode;            ///< Run generation and filtering on their own threads. Default: false.
+    int pipelineRingSize;         ///< Slots in each pipeline ring buffer. Default: 1024.
+    std::string logLevel;         ///< Most verbose level written to the log file: @c off, @c error, @c scale, @c info, @c request or @c trace. Default: @c "trace".
+    std::string consoleLevel;     ///< Most verbose level shown on the terminal (same names). Default: @c "request".
+    int consoleWindow;            ///< Console rate-limit window, in cycles. Default: 500.
+    int consoleBurst;             ///< Per-request console lines shown per tag per window (0 = no limit). Default: 5.
+    std::string logFormat;        ///< Log file format: @c text or @c binary (EventLogEncoder). Default: @c "text".
+    bool logAsync;                ///< Format and write the log file on a background thread. Default: false.
+    int logRingSize;              ///< LogRecords the async log ring holds. Default: 65536.
+    std::string logOverflow;      ///< Full async log ring: @c block (wait) or @c drop (discard and count). Default: @c "block".
+    std::string timeseriesFile;   ///< Per-cycle metrics output (TimeSeries); empty = not recorded. Default: empty.
+    std::string timeseriesFormat; ///< Time series output: @c csv or @c binary. Default: @c "csv".
+    int timeseriesWindow;         ///< Cycles per time series row (min/max/mean). Default: 1.
+    int timeseriesMaxRows;        ///< Most time series rows; widens the window for long runs. Default: 10000.
+    int metricsPort;              ///< Port of the HTTP metrics endpoint on 127.0.0.1 (MetricsServer); 0 = off. Default: 0.
+    int metricsInterval;          ///< Cycles between metrics snapshots. Default: 100.
+    int serverSlots;              ///< Concurrent requests per server. Default: 1.
+    std::string serverMode;       ///< @c "fcfs" (independent slots) or @c "ps" (processor sharing). Default: @c "fcfs".
+    std::vector<ServerType> serverTypes; ///< Heterogeneous pool mix; empty = identical speed-1 servers.
+    std::string scaleUpType;      ///< Type added on scale-up, or @c "auto" to size it to the backlog. Default: @c "auto".
+    int serverBootCycles;         ///< Provisioning delay before a scaled-up server takes work. Default: 0.
+    int serverWarmupCycles;       ///< Cycles a new server then runs below full speed. Default: 0.
+    double warmupSpeed;           ///< Fraction of full speed at the start of warm-up, ramping to 1. Default: 0.5.
+    std::string dispatchPolicy;   ///< Server selection policy (see DispatchPolicy::create()). Default: @c "first_idle".
+    int dispatchChoices;          ///< Servers sampled per decision by @c power_of_d. Default: 2.
+    int clientCount;              ///< Distinct client IPs requests come from (0 = a new random IP per request). Default: 0.
+    std::string cachePolicy;      ///< Per-server response cache: @c none, @c lru or @c tinylfu. Default: @c "none".
+    int cacheCapacity;            ///< Keys each server's cache holds. Default: 64.
+    std::string cacheKey;         ///< What the cache is keyed on: @c content or @c ip_out. Default: @c "content".
+    double cacheHitFactor;        ///< Fraction of timeRequired a cache hit still costs. Default: 0.2.
+    int contentCount;             ///< Distinct content keys (per client when clientCount is set). Default: 100.
+    std::string queueDiscipline;  ///< Queue order: @c fifo, @c sjf, @c srpt or @c size_interval. Default: @c "fifo".
+    int queueIntervalWidth;       ///< Cycles per size interval for @c size_interval. Default: 5.
+    std::vector<double> jobTypeWeights; ///< DRR weights for the P and S lanes; empty = one shared queue.
+    int streamTimeMultiplier;     ///< Scales timeRequired of streaming ('S') requests. Default: 1.
+    int requestTimeout;           ///< Mean cycles a client waits before giving up (0 = never). Default: 0.
+    std::string requestTimeoutDist; ///< @c fixed, @c uniform (0.5x-1.5x) or @c exponential. Default: @c "fixed".
+    int queueCapacity;            ///< Maximum queued requests across all shards (0 = unbounded). Default: 0.
+    std::string shedPolicy;       ///< @c drop_tail, @c drop_oldest, @c red or @c codel. Default: @c "drop_tail".
+    double redMaxProbability;     ///< RED drop probability as the average queue reaches capacity. Default: 0.1.
+    int codelTarget;              ///< CoDel target queue delay, in cycles. Default: 100.
+    int codelInterval;            ///< CoDel interval, in cycles. Default: 1000.
+    std::string scalingPolicy;    ///< Autoscaler (see ScalingPolicy::create()). Default: @c "threshold".
+    int scalingHorizon;           ///< Cycles ahead the predictive policy provisions for. Default: 100.
+    double targetUtilization;     ///< Pool utilization the predictive policy sizes for. Default: 0.8.
+    int sloWaitP95;               ///< p95 queue wait the @c pid policy aims for, in cycles. Default: 50.
+    double pidKp;                 ///< PID proportional gain (fraction of the pool per unit relative error). Default: 0.2.
+    double pidKi;                 ///< PID integral gain. Default: 0.1.
+    double pidKd;                 ///< PID derivative gain. Default: 0.1.
+    int pidMaxStep;               ///< Largest pool change per PID step. Default: 10.
+    int scaleMaxStep;             ///< Largest pool change per @c step scaling event. Default: 20.
+    bool scaleDownDrain;          ///< Drain busy servers when scale-down finds too few idle ones. Default: false.
+    int minServers;               ///< Smallest pool any scaling policy may shrink to. Default: 1.
+    int maxServers;               ///< Largest pool any scaling policy may grow to (0 = unbounded). Default: 0.
+    double forecastAlpha;         ///< Smoothing weight of the predictive policy's estimates. Default: 0.01.
     std::vector<std::string> blockedRanges; ///< IP ranges/CIDRs to block, loaded from config file.
 
     /**
@@ -46,6 +112,60 @@ struct Config {
         statusPrintInterval = 500;
         logFilePath = "load_balancer.log";
         seed = 0;
+        workerThreads = 1;
+        pipelineMode = false;
+        pipelineRingSize = 1024;
+        logLevel = "trace";
+        consoleLevel = "request";
+        consoleWindow = 500;
+        consoleBurst = 5;
+        logFormat = "text";
+        logAsync = false;
+        logRingSize = 65536;
+        logOverflow = "block";
+        timeseriesFile = "";
+        timeseriesFormat = "csv";
+        timeseriesWindow = 1;
+        timeseriesMaxRows = 10000;
+        metricsPort = 0;
+        metricsInterval = 100;
+        serverSlots = 1;
+        serverMode = "fcfs";
+        scaleUpType = "auto";
+        serverBootCycles = 0;
+        serverWarmupCycles = 0;
+        warmupSpeed = 0.5;
+        dispatchPolicy = "first_idle";
+        dispatchChoices = 2;
+        clientCount = 0;
+        cachePolicy = "none";
+        cacheCapacity = 64;
+        cacheKey = "content";
+        cacheHitFactor = 0.2;
+        contentCount = 100;
+        queueDiscipline = "fifo";
+        queueIntervalWidth = 5;
+        streamTimeMultiplier = 1;
+        requestTimeout = 0;
+        requestTimeoutDist = "fixed";
+        queueCapacity = 0;
+        shedPolicy = "drop_tail";
+        redMaxProbability = 0.1;
+        codelTarget = 100;
+        codelInterval = 1000;
+        scalingPolicy = "threshold";
+        scalingHorizon = 100;
+        targetUtilization = 0.8;
+        forecastAlpha = 0.01;
+        sloWaitP95 = 50;
+        pidKp = 0.2;
+        pidKi = 0.1;
+        pidKd = 0.1;
+        pidMaxStep = 10;
+        scaleMaxStep = 20;
+        scaleDownDrain = false;
+        minServers = 1;
+        maxServers = 0;
     }
 };
 
@@ -0,0 +1,127 @@
+// ConsoleSink.cpp
+
+#include "ConsoleSink.h"
+#include <cstring>
+
+// the buffer is written once it grows past this, even mid-window
+const size_t CONSOLE_FLUSH_BYTES = 64 * 1024;
+
+// nothing shown yet; the first window starts at cycle 0
+ConsoleSink::ConsoleSink(std::ostream& stream, LogLevel maxLevel, int windowCycles, int burstLines) : out(stream) {
+    level = maxLevel;
+    window = windowCycles < 1 ? 1 : windowCycles;
+    burst = burstLines < 0 ? 0 : burstLines;
+    windowStart = 0;
+    buffer.reserve(CONSOLE_FLUSH_BYTES + 4096);
+    lineCount = 0;
+    suppressedCount = 0;
+}
+
+// nothing left behind in the buffer
+ConsoleSink::~ConsoleSink() {
+    flush();
+}
+
+// level check only; the rate limit is applied in admit()
+bool ConsoleSink::wants(LogLevel lineLevel) const {
+    return lineLevel <= level;
+}
+
+// per-request lines go through the tag's limit, everything else is let in
+bool ConsoleSink::admit(LogLevel lineLevel, const char* tag, const char* color) {
+    if (lineLevel > level) {
+        return false;
+    }
+    if (lineLevel >= LOG_REQUEST && burst > 0) {
+        TagLimit& limit = limitFor(tag);
+        limit.color = color;
+        if (limit.shown >= burst) {
+            limit.dropped++;
+            suppressedCount++;
+            return false;
+        }
+        limit.shown++;
+    }
+    return true;
+}
+
+// straight into the buffer
+void ConsoleSink::write(const char* color, std::string_view line) {
+    append(color, line);
+}
+
+// close the window once it has run its length
+void ConsoleSink::advance(int cycle) {
+    if (cycle - windowStart >= window) {
+        closeWindow(cycle);
+        flush();
+    }
+}
+
+// partial last window, then everything out
+void ConsoleSink::finish(int cycle) {
+    closeWindow(cycle);
+    flush();
+}
+
+// one write for the whole batch
+void ConsoleSink::flush() {
+    if (!buffer.empty()) {
+        out.write(buffer.data(), buffer.size());
+        out.flush();
+        buffer.clear();
+    }
+}
+
+// getter for lines written
+long long ConsoleSink::lines() const {
+    return lineCount;
+}
+
+// getter for lines suppressed
+long long ConsoleSink::suppressed() const {
+    return suppressedCount;
+}
+
+// few distinct tags, so a linear scan beats a map
+ConsoleSink::TagLimit& ConsoleSink::limitFor(const char* tag) {
+    for (int i = 0; i < (int)limits.size(); i++) {
+        if (limits[i].tag == tag || strcmp(limits[i].tag, tag) == 0) {
+            return limits[i];
+        }
+    }
+    TagLimit limit;
+    limit.tag = tag;
+    limit.color = RESET;
+    limit.shown = 0;
+    limit.dropped = 0;
+    limits.push_back(limit);
+    return limits.back();
+}
+
+// color, text, reset, newline
+void ConsoleSink::append(const char* color, std::string_view line) {
+    buffer += color;
+    buffer.append(line.data(), line.size());
+    buffer += RESET;
+    buffer += '\n';
+    lineCount++;
+    if (buffer.size() >= CONSOLE_FLUSH_BYTES) {
+        flush();
+    }
+}
+
+// one summary per tag that lost lines, then reset the counts
+void ConsoleSink::closeWindow(int cycle) {
+    for (int i = 0; i < (int)limits.size(); i++) {
+        TagLimit& limit = limits[i];
+        if (limit.dropped > 0) {
+            summary.clear();
+            summary << '[' << limit.tag << "] " << limit.dropped << ' ' << limit.tag << " events suppressed in last " << cycle - windowStart << " cycles";
+            append(limit.color, summary.view());
+        }
+        limit.shown = 0;
+        limit.dropped = 0;
+    }
+    windowStart = cycle;
+}
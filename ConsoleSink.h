@@ -0,0 +1,132 @@
+/**
+ * @file ConsoleSink.h
+ * @brief Defines ConsoleSink, the rate-limited and buffered terminal side
+ *        of the simulation log.
+ *
+ * @author Karan Bhagat
+ * @date 2026
+ */
+
+#ifndef CONSOLESINK_H
+#define CONSOLESINK_H
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "AsyncLogger.h"
+#include "LogBuffer.h"
+
+// ANSI color codes for terminal output
+#define RESET  "\033[0m"
+#define CYAN   "\033[36m"
+#define GREEN  "\033[32m"
+#define YELLOW "\033[33m"
+#define RED    "\033[31m"
+
+/**
+ * @class ConsoleSink
+ * @brief Terminal output with its own level, per-tag rate limiting and
+ *        batched writes.
+ *
+ * Callers ask admit() before formatting a line, so a line that is not
+ * shown costs a level check and a counter. Per-request lines (LOG_REQUEST
+ * and above) are limited to @c burst per tag per window of @c window
+ * cycles; the rest are counted, and when the window closes each tag that
+ * lost lines gets one summary such as
+ * @c "[BLOCK] 1234 BLOCK events suppressed in last 500 cycles".
+ * Scale, info and error lines are never suppressed.
+ *
+ * Admitted lines are appended to a buffer and written in one call at the
+ * end of each window, when the buffer passes 64 KB, or on flush().
+ *
+ * The sink only sees what is sent to it; the log file is written
+ * separately and gets every event at its own level.
+ */
+class ConsoleSink {
+public:
+    /**
+     * @brief Constructor.
+     * @param out    Terminal stream.
+     * @param level  Most verbose LogLevel shown.
+     * @param window Rate-limit window, in cycles (at least 1).
+     * @param burst  Per-request lines shown per tag per window (0 = no limit).
+     */
+    ConsoleSink(std::ostream& out, LogLevel level, int window, int burst);
+
+    /** @brief Destructor. Flushes what is buffered. */
+    ~ConsoleSink();
+
+    ConsoleSink(const ConsoleSink&) = delete;
+    ConsoleSink& operator=(const ConsoleSink&) = delete;
+
+    /** @brief @c true if lines at @p level can be shown at all. */
+    bool wants(LogLevel level) const;
+
+    /**
+     * @brief Decides whether the next line is shown, counting it against
+     *        its tag's limit (or as suppressed).
+     * @param level Level of the line.
+     * @param tag   Tag the limit is kept by (e.g. "BLOCK"); compared by content.
+     * @param color ANSI color of the tag, used for its summary.
+     * @return @c true if the caller should write() the line.
+     */
+    bool admit(LogLevel level, const char* tag, const char* color);
+
+    /**
+     * @brief Buffers one admitted line.
+     * @param color ANSI color for the line.
+     * @param line  Text without newline.
+     */
+    void write(const char* color, std::string_view line);
+
+    /**
+     * @brief Moves the sink to @p cycle, closing the window (summaries and
+     *        a flush) if it has run its length. Call once per cycle.
+     */
+    void advance(int cycle);
+
+    /** @brief Writes summaries for the open window and flushes everything. */
+    void finish(int cycle);
+
+    /** @brief Writes the buffer to the stream. */
+    void flush();
+
+    /** @brief Lines written to the terminal, summaries included. */
+    long long lines() const;
+
+    /** @brief Lines suppressed by the rate limit. */
+    long long suppressed() const;
+
+private:
+    /** @brief Rate-limit state of one tag. */
+    struct TagLimit {
+        const char* tag;    ///< Tag text (a literal owned by the caller).
+        const char* color;  ///< Color of its last line, reused for the summary.
+        int shown;          ///< Lines shown in the current window.
+        long long dropped;  ///< Lines suppressed in the current window.
+    };
+
+    /** @brief Limit slot for @p tag, created on first use. */
+    TagLimit& limitFor(const char* tag);
+
+    /** @brief Appends one colored line to the buffer. */
+    void append(const char* color, std::string_view line);
+
+    /** @brief Summaries for tags that lost lines, then a new window from @p cycle. */
+    void closeWindow(int cycle);
+
+    std::ostream& out;              ///< Terminal stream.
+    LogLevel level;                 ///< Most verbose level shown.
+    int window;                     ///< Window length in cycles.
+    int burst;                      ///< Lines per tag per window (0 = no limit).
+    int windowStart;                ///< First cycle of the current window.
+    std::string buffer;             ///< Lines not yet written.
+    std::vector<TagLimit> limits;   ///< One entry per tag seen.
+    LogBuffer summary;              ///< Reused for the suppression summaries.
+    long long lineCount;            ///< Lines written.
+    long long suppressedCount;      ///< Lines suppressed.
+};
+
+#endif
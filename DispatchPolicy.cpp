@@ -0,0 +1,584 @@
+// DispatchPolicy.cpp
+
+#include "DispatchPolicy.h"
+#include <chrono>
+#include <unordered_map>
+#include <unordered_set>
+
+// keys sampled to measure how much of the key space a rebuild remaps
+const int AFFINITY_PROBE_KEYS = 4096;
+// smallest Maglev table; the paper's default, far above the usual per-shard pool
+const int MAGLEV_MIN_TABLE = 65537;
+
+// look up a policy by its config name
+DispatchPolicy* DispatchPolicy::create(const std::string& name, int choices, unsigned int seed) {
+    if (name == "first_idle") {
+        return new FirstIdlePolicy();
+    }
+    if (name == "round_robin") {
+        return new RoundRobinPolicy();
+    }
+    if (name == "least_outstanding") {
+        return new LeastOutstandingPolicy();
+    }
+    if (name == "jsq") {
+        return new JoinShortestQueuePolicy();
+    }
+    if (name == "power_of_d") {
+        return new PowerOfDPolicy(choices, seed);
+    }
+    if (name == "least_work_left") {
+        return new LeastWorkLeftPolicy();
+    }
+    if (name == "weighted") {
+        return new WeightedPolicy();
+    }
+    if (name == "maglev") {
+        return new MaglevPolicy();
+    }
+    if (name == "jump_hash") {
+        return new JumpHashPolicy();
+    }
+    return nullptr;
+}
+
+// true if create() knows this name
+bool DispatchPolicy::isKnown(const std::string& name) {
+    DispatchPolicy* policy = create(name, 1, 0);
+    delete policy;
+    return policy != nullptr;
+}
+
+// no affinity, nothing counted
+AffinityStats DispatchPolicy::affinityStats() const {
+    return AffinityStats();
+}
+
+// most policies do not care which shard a request lands on
+bool DispatchPolicy::clientAffinity() const {
+    return false;
+}
+
+// add another shard's counters
+void AffinityStats::merge(const AffinityStats& other) {
+    lookups += other.lookups;
+    fallbacks += other.fallbacks;
+    rebuilds += other.rebuilds;
+    rebuildSeconds += other.rebuildSeconds;
+    remappedSum += other.remappedSum;
+    if (other.maxRemapped > maxRemapped) {
+        maxRemapped = other.maxRemapped;
+    }
+}
+
+// ---- KeyedPolicy ----
+
+KeyedPolicy::KeyedPolicy() {
+    pool = nullptr;
+}
+
+// re-key every server from scratch
+void KeyedPolicy::rebuild(const std::vector<WebServer*>& servers, int now) {
+    pool = &servers;
+    keys.assign(servers.size(), 0);
+    listed.assign(servers.size(), false);
+    ready.clear();
+    for (int i = 0; i < (int)servers.size(); i++) {
+        refresh(i, now);
+    }
+}
+
+// smallest key wins
+int KeyedPolicy::pick(const Request& request, int now) {
+    (void)request;
+    (void)now;
+    if (ready.empty()) {
+        return -1;
+    }
+    return ready.begin()->second;
+}
+
+// server state changed, move it in the set
+void KeyedPolicy::onAssigned(int server, const Request& request, int now) {
+    (void)request;
+    refresh(server, now);
+}
+
+// server state changed, move it in the set
+void KeyedPolicy::onCompleted(int server, int now) {
+    refresh(server, now);
+}
+
+// drop the old entry, then re-insert with a fresh key if the server can take work
+void KeyedPolicy::refresh(int server, int now) {
+    bool available = (*pool)[server]->isAvailable();
+    long long key = available ? keyFor(server, now) : 0;
+    if (listed[server] && available && key == keys[server]) {
+        return;
+    }
+
+    if (listed[server]) {
+        ready.erase(std::make_pair(keys[server], server));
+        listed[server] = false;
+    }
+    if (available) {
+        keys[server] = key;
+        ready.insert(std::make_pair(keys[server], server));
+        listed[server] = true;
+    }
+}
+
+// ---- FirstIdlePolicy ----
+
+FirstIdlePolicy::FirstIdlePolicy() {
+}
+
+std::string FirstIdlePolicy::name() const {
+    return "first_idle";
+}
+
+// lower index first
+long long FirstIdlePolicy::keyFor(int server, int now) const {
+    (void)now;
+    return server;
+}
+
+// ---- LeastOutstandingPolicy ----
+
+LeastOutstandingPolicy::LeastOutstandingPolicy() {
+}
+
+std::string LeastOutstandingPolicy::name() const {
+    return "least_outstanding";
+}
+
+// fewer in-flight requests first
+long long LeastOutstandingPolicy::keyFor(int server, int now) const {
+    (void)now;
+    return (*pool)[server]->activeRequests();
+}
+
+// ---- JoinShortestQueuePolicy ----
+
+JoinShortestQueuePolicy::JoinShortestQueuePolicy() {
+}
+
+std::string JoinShortestQueuePolicy::name() const {
+    return "jsq";
+}
+
+// lowest fraction of slots in use first, then whichever drains sooner
+long long JoinShortestQueuePolicy::keyFor(int server, int now) const {
+    const WebServer* target = (*pool)[server];
+    long long occupancy = (long long)target->activeRequests() * 65536 / target->slotCount();
+    long long drainAt = (long long)now + target->remainingWork();
+    return (occupancy << 32) | drainAt;
+}
+
+// ---- LeastWorkLeftPolicy ----
+
+LeastWorkLeftPolicy::LeastWorkLeftPolicy() {
+}
+
+std::string LeastWorkLeftPolicy::name() const {
+    return "least_work_left";
+}
+
+// absolute cycle the server's current work is projected to finish
+long long LeastWorkLeftPolicy::keyFor(int server, int now) const {
+    const WebServer* target = (*pool)[server];
+    return (long long)now + (long long)(target->remainingWork() / target->serviceRate() + 0.999999);
+}
+
+// ---- WeightedPolicy ----
+
+WeightedPolicy::WeightedPolicy() {
+}
+
+std::string WeightedPolicy::name() const {
+    return "weighted";
+}
+
+// load per unit of capacity after taking one more request
+long long WeightedPolicy::keyFor(int server, int now) const {
+    (void)now;
+    const WebServer* target = (*pool)[server];
+    return (long long)((target->activeRequests() + 1) * 1000000.0 / target->serviceRate());
+}
+
+// ---- RoundRobinPolicy ----
+
+RoundRobinPolicy::RoundRobinPolicy() {
+    pool = nullptr;
+    cursor = 0;
+}
+
+std::string RoundRobinPolicy::name() const {
+    return "round_robin";
+}
+
+// rebuild the set of available servers
+void RoundRobinPolicy::rebuild(const std::vector<WebServer*>& servers, int now) {
+    (void)now;
+    pool = &servers;
+    ready.clear();
+    for (int i = 0; i < (int)servers.size(); i++) {
+        refresh(i);
+    }
+    if (cursor >= (int)servers.size()) {
+        cursor = 0;
+    }
+}
+
+// first available server at or after the cursor, wrapping around
+int RoundRobinPolicy::pick(const Request& request, int now) {
+    (void)request;
+    (void)now;
+    if (ready.empty()) {
+        return -1;
+    }
+    std::set<int>::iterator it = ready.lower_bound(cursor);
+    if (it == ready.end()) {
+        it = ready.begin();
+    }
+    cursor = *it + 1;
+    return *it;
+}
+
+void RoundRobinPolicy::onAssigned(int server, const Request& request, int now) {
+    (void)request;
+    (void)now;
+    refresh(server);
+}
+
+void RoundRobinPolicy::onCompleted(int server, int now) {
+    (void)now;
+    refresh(server);
+}
+
+// keep the set in sync with the server's availability
+void RoundRobinPolicy::refresh(int server) {
+    if ((*pool)[server]->isAvailable()) {
+        ready.insert(server);
+    } else {
+        ready.erase(server);
+    }
+}
+
+// ---- PowerOfDPolicy ----
+
+PowerOfDPolicy::PowerOfDPolicy(int choices, unsigned int seed) {
+    pool = nullptr;
+    d = choices < 1 ? 1 : choices;
+    // xorshift must not start at zero
+    rngState = 0x9E3779B97F4A7C15ULL ^ seed;
+    if (rngState == 0) {
+        rngState = 1;
+    }
+}
+
+std::string PowerOfDPolicy::name() const {
+    return "power_of_d";
+}
+
+// rebuild the dense list of available servers
+void PowerOfDPolicy::rebuild(const std::vector<WebServer*>& servers, int now) {
+    (void)now;
+    pool = &servers;
+    ready.clear();
+    position.assign(servers.size(), -1);
+    for (int i = 0; i < (int)servers.size(); i++) {
+        refresh(i);
+    }
+}
+
+// sample d available servers, keep the least loaded
+int PowerOfDPolicy::pick(const Request& request, int now) {
+    (void)request;
+    (void)now;
+    if (ready.empty()) {
+        return -1;
+    }
+
+    int best = ready[nextRandom((int)ready.size())];
+    for (int i = 1; i < d; i++) {
+        int candidate = ready[nextRandom((int)ready.size())];
+        if ((*pool)[candidate]->activeRequests() < (*pool)[best]->activeRequests()) {
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+void PowerOfDPolicy::onAssigned(int server, const Request& request, int now) {
+    (void)request;
+    (void)now;
+    refresh(server);
+}
+
+void PowerOfDPolicy::onCompleted(int server, int now) {
+    (void)now;
+    refresh(server);
+}
+
+// add to or swap-remove from the dense list
+void PowerOfDPolicy::refresh(int server) {
+    bool available = (*pool)[server]->isAvailable();
+    if (available && position[server] == -1) {
+        position[server] = (int)ready.size();
+        ready.push_back(server);
+    } else if (!available && position[server] != -1) {
+        int slot = position[server];
+        int last = ready.back();
+        ready[slot] = last;
+        position[last] = slot;
+        ready.pop_back();
+        position[server] = -1;
+    }
+}
+
+// xorshift64, reduced to [0, bound)
+int PowerOfDPolicy::nextRandom(int bound) {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return (int)(rngState % (unsigned long long)bound);
+}
+
+// ---- AffinityPolicy ----
+
+AffinityPolicy::AffinityPolicy() {
+    pool = nullptr;
+}
+
+// FNV-1a, then a splitmix64 finaliser so similar strings spread out
+unsigned long long AffinityPolicy::hashKey(const std::string& key, unsigned long long seed) {
+    unsigned long long hash = 14695981039346656037ULL ^ seed;
+    for (int i = 0; i < (int)key.size(); i++) {
+        hash ^= (unsigned char)key[i];
+        hash *= 1099511628211ULL;
+    }
+    hash ^= hash >> 30;
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94D049BB133111EBULL;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+// refresh availability; rebuild the table only if servers joined or left
+void AffinityPolicy::rebuild(const std::vector<WebServer*>& servers, int now) {
+    (void)now;
+    pool = &servers;
+    ready.clear();
+    for (int i = 0; i < (int)servers.size(); i++) {
+        refresh(i);
+    }
+
+    std::vector<std::string> ids(servers.size());
+    for (int i = 0; i < (int)servers.size(); i++) {
+        ids[i] = servers[i]->id();
+    }
+    if (ids == members) {
+        return;
+    }
+
+    // owners of the probe keys under the old table, by id
+    std::vector<std::string> before;
+    if (!members.empty()) {
+        before.resize(AFFINITY_PROBE_KEYS);
+        for (int k = 0; k < AFFINITY_PROBE_KEYS; k++) {
+            before[k] = members[lookup(hashKey(std::to_string(k), 0))];
+        }
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    buildTable(ids);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    members = ids;
+    if (before.empty()) {
+        return;
+    }
+
+    int moved = 0;
+    for (int k = 0; k < AFFINITY_PROBE_KEYS; k++) {
+        int owner = lookup(hashKey(std::to_string(k), 0));
+        if (owner < 0 || members[owner] != before[k]) {
+            moved++;
+        }
+    }
+    double fraction = (double)moved / AFFINITY_PROBE_KEYS;
+    counters.rebuilds++;
+    counters.rebuildSeconds += seconds;
+    counters.remappedSum += fraction;
+    if (fraction > counters.maxRemapped) {
+        counters.maxRemapped = fraction;
+    }
+}
+
+// the client's server if it can take work, else the next available one
+int AffinityPolicy::pick(const Request& request, int now) {
+    (void)now;
+    if (ready.empty()) {
+        return -1;
+    }
+
+    counters.lookups++;
+    int preferred = lookup(hashKey(request.ipIn, 0));
+    if (ready.count(preferred) > 0) {
+        return preferred;
+    }
+    counters.fallbacks++;
+    std::set<int>::iterator it = ready.lower_bound(preferred);
+    if (it == ready.end()) {
+        it = ready.begin();
+    }
+    return *it;
+}
+
+void AffinityPolicy::onAssigned(int server, const Request& request, int now) {
+    (void)request;
+    (void)now;
+    refresh(server);
+}
+
+void AffinityPolicy::onCompleted(int server, int now) {
+    (void)now;
+    refresh(server);
+}
+
+// getter for the affinity counters
+AffinityStats AffinityPolicy::affinityStats() const {
+    return counters;
+}
+
+// the mapping is per shard, so a client must always reach the same one
+bool AffinityPolicy::clientAffinity() const {
+    return true;
+}
+
+// keep the set in sync with the server's availability
+void AffinityPolicy::refresh(int server) {
+    if ((*pool)[server]->isAvailable()) {
+        ready.insert(server);
+    } else {
+        ready.erase(server);
+    }
+}
+
+// ---- MaglevPolicy ----
+
+MaglevPolicy::MaglevPolicy() {
+}
+
+std::string MaglevPolicy::name() const {
+    return "maglev";
+}
+
+// smallest prime >= n, by trial division (n is at most a few million)
+static int nextPrime(int n) {
+    for (;; n++) {
+        bool prime = n > 1;
+        for (int d = 2; prime && (long long)d * d <= n; d++) {
+            prime = n % d != 0;
+        }
+        if (prime) {
+            return n;
+        }
+    }
+}
+
+// members take turns claiming the next free slot along their own permutation
+void MaglevPolicy::buildTable(const std::vector<std::string>& members) {
+    int n = (int)members.size();
+    if (n == 0) {
+        table.clear();
+        return;
+    }
+    int size = nextPrime(n * 100 > MAGLEV_MIN_TABLE ? n * 100 : MAGLEV_MIN_TABLE);
+    std::vector<long long> offset(n);
+    std::vector<long long> skip(n);
+    std::vector<long long> next(n, 0);
+    for (int i = 0; i < n; i++) {
+        offset[i] = (long long)(hashKey(members[i], 1) % (unsigned long long)size);
+        skip[i] = (long long)(hashKey(members[i], 2) % (unsigned long long)(size - 1)) + 1;
+    }
+
+    table.assign(size, -1);
+    int filled = 0;
+    while (filled < size) {
+        for (int i = 0; i < n && filled < size; i++) {
+            long long slot = (offset[i] + next[i] * skip[i]) % size;
+            while (table[slot] >= 0) {
+                next[i]++;
+                slot = (offset[i] + next[i] * skip[i]) % size;
+            }
+            table[slot] = i;
+            next[i]++;
+            filled++;
+        }
+    }
+}
+
+// one table read
+int MaglevPolicy::lookup(unsigned long long hash) const {
+    if (table.empty()) {
+        return -1;
+    }
+    return table[hash % table.size()];
+}
+
+// ---- JumpHashPolicy ----
+
+JumpHashPolicy::JumpHashPolicy() {
+}
+
+std::string JumpHashPolicy::name() const {
+    return "jump_hash";
+}
+
+// departed servers' slots take the last slot's server; newcomers are appended
+void JumpHashPolicy::buildTable(const std::vector<std::string>& members) {
+    std::unordered_map<std::string, int> index;
+    for (int i = 0; i < (int)members.size(); i++) {
+        index[members[i]] = i;
+    }
+    int slot = 0;
+    while (slot < (int)slots.size()) {
+        if (index.count(slots[slot]) > 0) {
+            slot++;
+        } else {
+            // re-check the same slot: the server moved into it may also have left
+            slots[slot] = slots.back();
+            slots.pop_back();
+        }
+    }
+    // servers without a slot joined since the last build; they go on the end in list order
+    std::unordered_set<std::string> placed(slots.begin(), slots.end());
+    for (int i = 0; i < (int)members.size(); i++) {
+        if (placed.count(members[i]) == 0) {
+            slots.push_back(members[i]);
+        }
+    }
+
+    slotMember.resize(slots.size());
+    for (int s = 0; s < (int)slots.size(); s++) {
+        slotMember[s] = index[slots[s]];
+    }
+}
+
+// Lamping and Veach, "A Fast, Minimal Memory, Consistent Hash Algorithm"
+int JumpHashPolicy::lookup(unsigned long long hash) const {
+    long long buckets = (long long)slots.size();
+    if (buckets == 0) {
+        return -1;
+    }
+    long long b = -1;
+    long long j = 0;
+    while (j < buckets) {
+        b = j;
+        hash = hash * 2862933555777941757ULL + 1;
+        j = (long long)((b + 1) * ((double)(1LL << 31) / (double)((hash >> 33) + 1)));
+    }
+    return slotMember[b];
+}
@@ -0,0 +1,410 @@
+/**
+ * @file DispatchPolicy.h
+ * @brief Defines the DispatchPolicy interface and the built-in policies that
+ *        decide which server receives the next queued request.
+ *
+ * @author Karan Bhagat
+ * @date 2026
+ */
+
+#ifndef DISPATCHPOLICY_H
+#define DISPATCHPOLICY_H
+
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Request.h"
+#include "WebServer.h"
+
+/**
+ * @struct AffinityStats
+ * @brief Counters kept by the client-affinity policies (AffinityPolicy).
+ *
+ * Disruption is measured on a fixed sample of hash keys: the fraction of
+ * them whose server changed when the lookup table was rebuilt after the
+ * pool membership changed.
+ */
+struct AffinityStats {
+    long long lookups;     ///< Requests routed by client hash.
+    long long fallbacks;   ///< Of those, requests whose affined server could not take work.
+    int rebuilds;          ///< Table rebuilds after a membership change (the initial build excluded).
+    double rebuildSeconds; ///< Wall time spent in those rebuilds.
+    double remappedSum;    ///< Sum over rebuilds of the fraction of keys remapped.
+    double maxRemapped;    ///< Largest fraction of keys remapped by one rebuild.
+
+    AffinityStats() {
+        lookups = 0;
+        fallbacks = 0;
+        rebuilds = 0;
+        rebuildSeconds = 0.0;
+        remappedSum = 0.0;
+        maxRemapped = 0.0;
+    }
+
+    /** @brief Adds another shard's counters to these. */
+    void merge(const AffinityStats& other);
+};
+
+/**
+ * @class DispatchPolicy
+ * @brief Chooses a server for each request leaving a Shard's queue.
+ *
+ * A policy only ever returns servers that can accept another request
+ * (WebServer::isAvailable()). It keeps its own index of those servers and
+ * is told about every assignment and completion, so a decision never has
+ * to scan the pool. Whenever servers are added or removed the owning Shard
+ * calls rebuild(), which recomputes the index from the servers' state.
+ */
+class DispatchPolicy {
+public:
+    virtual ~DispatchPolicy() {}
+
+    /** @brief Config name of the policy (e.g. @c "round_robin"). */
+    virtual std::string name() const = 0;
+
+    /**
+     * @brief Rebuilds the policy's index after the pool changed.
+     * @param servers The shard's server list; must outlive the policy.
+     * @param now     Current simulation cycle.
+     */
+    virtual void rebuild(const std::vector<WebServer*>& servers, int now) = 0;
+
+    /**
+     * @brief Picks the server for @p request.
+     * @param request Request about to be dispatched.
+     * @param now     Current simulation cycle.
+     * @return Index into the server list, or -1 if no server can accept work.
+     */
+    virtual int pick(const Request& request, int now) = 0;
+
+    /**
+     * @brief Called after @p request has been handed to server @p server.
+     * @param server  Index of the server that accepted the request.
+     * @param request The request that was dispatched.
+     * @param now     Current simulation cycle.
+     */
+    virtual void onAssigned(int server, const Request& request, int now) = 0;
+
+    /**
+     * @brief Called after server @p server finished a request.
+     * @param server Index of the server.
+     * @param now    Current simulation cycle.
+     */
+    virtual void onCompleted(int server, int now) = 0;
+
+    /**
+     * @brief Affinity counters for the summary.
+     * @return The policy's AffinityStats; all zero for policies without affinity.
+     */
+    virtual AffinityStats affinityStats() const;
+
+    /**
+     * @brief @c true if the policy keeps each client on one server, so all of
+     *        a client's requests must reach the same shard.
+     */
+    virtual bool clientAffinity() const;
+
+    /**
+     * @brief Creates a policy by its config name.
+     *
+     * Known names: @c first_idle, @c round_robin, @c least_outstanding,
+     * @c jsq, @c power_of_d, @c least_work_left, @c weighted, @c maglev
+     * and @c jump_hash.
+     *
+     * @param name    Policy name from the config file.
+     * @param choices Servers sampled per decision by @c power_of_d.
+     * @param seed    Seed for policies that sample randomly.
+     * @return A new heap-allocated policy, or @c nullptr for an unknown name.
+     */
+    static DispatchPolicy* create(const std::string& name, int choices, unsigned int seed);
+
+    /**
+     * @brief Checks whether create() recognises a policy name.
+     * @param name Policy name from the config file.
+     * @return @c true if @p name is a built-in policy.
+     */
+    static bool isKnown(const std::string& name);
+};
+
+/**
+ * @class KeyedPolicy
+ * @brief Base for policies that always pick the available server with the
+ *        smallest key.
+ *
+ * Available servers are kept in an ordered set of (key, index) pairs, so a
+ * pick is O(1) and each assignment or completion is O(log n). Subclasses
+ * only define how a server's key is computed; keys must not change between
+ * events for the same server (use absolute times rather than countdowns).
+ */
+class KeyedPolicy : public DispatchPolicy {
+public:
+    KeyedPolicy();
+    void rebuild(const std::vector<WebServer*>& servers, int now) override;
+    int pick(const Request& request, int now) override;
+    void onAssigned(int server, const Request& request, int now) override;
+    void onCompleted(int server, int now) override;
+
+protected:
+    /**
+     * @brief Computes the ordering key of server @p server.
+     * @param server Index of the server.
+     * @param now    Current simulation cycle.
+     * @return Key; the available server with the smallest key is picked.
+     */
+    virtual long long keyFor(int server, int now) const = 0;
+
+    const std::vector<WebServer*>* pool; ///< The owning shard's servers.
+
+private:
+    std::vector<long long> keys;                 ///< Key each server was last inserted with.
+    std::vector<bool> listed;                    ///< Whether each server is in @c ready.
+    std::set<std::pair<long long, int> > ready;  ///< Available servers ordered by key.
+
+    /** @brief Re-keys one server and (re)inserts it if it can take work. */
+    void refresh(int server, int now);
+};
+
+/**
+ * @class FirstIdlePolicy
+ * @brief Lowest-index available server; the simulator's original behaviour.
+ */
+class FirstIdlePolicy : public KeyedPolicy {
+public:
+    FirstIdlePolicy();
+    std::string name() const override;
+
+protected:
+    long long keyFor(int server, int now) const override;
+};
+
+/**
+ * @class LeastOutstandingPolicy
+ * @brief Available server with the fewest requests in flight.
+ */
+class LeastOutstandingPolicy : public KeyedPolicy {
+public:
+    LeastOutstandingPolicy();
+    std::string name() const override;
+
+protected:
+    long long keyFor(int server, int now) const override;
+};
+
+/**
+ * @class JoinShortestQueuePolicy
+ * @brief Available server with the shortest queue relative to its size:
+ *        lowest fraction of slots in use, ties broken by the earliest
+ *        projected drain time.
+ */
+class JoinShortestQueuePolicy : public KeyedPolicy {
+public:
+    JoinShortestQueuePolicy();
+    std::string name() const override;
+
+protected:
+    long long keyFor(int server, int now) const override;
+};
+
+/**
+ * @class LeastWorkLeftPolicy
+ * @brief Available server whose outstanding work finishes soonest.
+ *
+ * The key is the absolute cycle the server's current work is projected to
+ * drain at, which stays valid while the server ticks down.
+ */
+class LeastWorkLeftPolicy : public KeyedPolicy {
+public:
+    LeastWorkLeftPolicy();
+    std::string name() const override;
+
+protected:
+    long long keyFor(int server, int now) const override;
+};
+
+/**
+ * @class WeightedPolicy
+ * @brief Weighted least-connections: the available server with the lowest
+ *        (requests in flight + 1) / service rate.
+ *
+ * A server twice as fast as another receives twice as many concurrent
+ * requests before it stops being preferred, so work is spread in
+ * proportion to capacity.
+ */
+class WeightedPolicy : public KeyedPolicy {
+public:
+    WeightedPolicy();
+    std::string name() const override;
+
+protected:
+    long long keyFor(int server, int now) const override;
+};
+
+/**
+ * @class RoundRobinPolicy
+ * @brief Cycles through the servers, skipping any that cannot take work.
+ *
+ * Available servers are kept in an ordered set of indices; each pick is the
+ * first available index at or after the cursor, wrapping around. O(log n).
+ */
+class RoundRobinPolicy : public DispatchPolicy {
+public:
+    RoundRobinPolicy();
+    std::string name() const override;
+    void rebuild(const std::vector<WebServer*>& servers, int now) override;
+    int pick(const Request& request, int now) override;
+    void onAssigned(int server, const Request& request, int now) override;
+    void onCompleted(int server, int now) override;
+
+private:
+    const std::vector<WebServer*>* pool; ///< The owning shard's servers.
+    std::set<int> ready;                 ///< Indices of available servers.
+    int cursor;                          ///< Index to start the next search from.
+
+    /** @brief Adds or removes one server from @c ready based on its state. */
+    void refresh(int server);
+};
+
+/**
+ * @class PowerOfDPolicy
+ * @brief Samples @c d available servers at random and picks the one with the
+ *        fewest requests in flight.
+ *
+ * Available servers live in a dense array with a position map so sampling,
+ * insertion and removal are all O(1); a decision costs O(d).
+ */
+class PowerOfDPolicy : public DispatchPolicy {
+public:
+    /**
+     * @param choices Servers sampled per decision (minimum 1).
+     * @param seed    Seed for the policy's private random generator.
+     */
+    PowerOfDPolicy(int choices, unsigned int seed);
+    std::string name() const override;
+    void rebuild(const std::vector<WebServer*>& servers, int now) override;
+    int pick(const Request& request, int now) override;
+    void onAssigned(int server, const Request& request, int now) override;
+    void onCompleted(int server, int now) override;
+
+private:
+    const std::vector<WebServer*>* pool; ///< The owning shard's servers.
+    std::vector<int> ready;              ///< Dense list of available server indices.
+    std::vector<int> position;           ///< position[i] = slot of server i in @c ready, or -1.
+    int d;                               ///< Servers sampled per decision.
+    unsigned long long rngState;         ///< xorshift64 state.
+
+    /** @brief Adds or removes one server from @c ready based on its state. */
+    void refresh(int server);
+
+    /** @brief Returns a random index in [0, bound). */
+    int nextRandom(int bound);
+};
+
+/**
+ * @class AffinityPolicy
+ * @brief Base for policies that send each client (Request::ipIn) to the
+ *        same server for as long as the pool membership stays the same.
+ *
+ * Subclasses build a lookup structure from the servers' ids and map a key
+ * hash to a server. The structure is only rebuilt when servers join or
+ * leave, not when a server merely becomes busy or idle, and each rebuild is
+ * timed and its disruption measured (see AffinityStats). When the affined
+ * server cannot take work the request goes to the next available server in
+ * index order (an ordered set of available indices, O(log n)), so clients
+ * of a busy server spill over without disturbing anyone else's mapping.
+ */
+class AffinityPolicy : public DispatchPolicy {
+public:
+    AffinityPolicy();
+    void rebuild(const std::vector<WebServer*>& servers, int now) override;
+    int pick(const Request& request, int now) override;
+    void onAssigned(int server, const Request& request, int now) override;
+    void onCompleted(int server, int now) override;
+    AffinityStats affinityStats() const override;
+    bool clientAffinity() const override;
+
+    /**
+     * @brief 64-bit hash of a string (FNV-1a followed by a finalising mix).
+     * @param key  Text to hash.
+     * @param seed Varies the hash so one key can yield independent values.
+     * @return Hash value.
+     */
+    static unsigned long long hashKey(const std::string& key, unsigned long long seed);
+
+protected:
+    /**
+     * @brief Rebuilds the lookup structure for a new membership.
+     * @param members Server ids, in server list order.
+     */
+    virtual void buildTable(const std::vector<std::string>& members) = 0;
+
+    /**
+     * @brief Maps a key hash to a server.
+     * @param hash Value from hashKey().
+     * @return Index into the member list, or -1 if there are no members.
+     */
+    virtual int lookup(unsigned long long hash) const = 0;
+
+private:
+    const std::vector<WebServer*>* pool; ///< The owning shard's servers.
+    std::set<int> ready;                 ///< Indices of available servers.
+    std::vector<std::string> members;    ///< Server ids the table was built from.
+    AffinityStats counters;              ///< Lookups, fallbacks and rebuild costs.
+
+    /** @brief Adds or removes one server from @c ready based on its state. */
+    void refresh(int server);
+};
+
+/**
+ * @class MaglevPolicy
+ * @brief Maglev consistent hashing: a lookup table of prime size M filled
+ *        from each server's own permutation of the slots.
+ *
+ * Every server takes slots in turn along its permutation (offset and skip
+ * derived from its id), so each owns about M/N slots and removing a server
+ * hands mostly its own slots to others. A lookup is one table read.
+ * M is the smallest prime of at least MAGLEV_MIN_TABLE and 100 slots per
+ * server; a rebuild costs O(M log M) on average.
+ */
+class MaglevPolicy : public AffinityPolicy {
+public:
+    MaglevPolicy();
+    std::string name() const override;
+
+protected:
+    void buildTable(const std::vector<std::string>& members) override;
+    int lookup(unsigned long long hash) const override;
+
+private:
+    std::vector<int> table; ///< Slot -> member index.
+};
+
+/**
+ * @class JumpHashPolicy
+ * @brief Jump consistent hashing (Lamping and Veach) over a stable slot list.
+ *
+ * Jump hash maps a key to a bucket in [0, N) and only stays consistent when
+ * buckets are added or removed at the end. Buckets are therefore slots
+ * holding server ids, kept across rebuilds rather than taken from the
+ * shard's list order: a joining server takes a new slot at the end, and a
+ * leaving server's slot is filled by the last slot's server before the
+ * list shrinks by one. Removing one server remaps only its own keys and
+ * those of the last slot (about 2/N of the key space); adding one remaps
+ * about 1/N. A lookup is O(log N).
+ */
+class JumpHashPolicy : public AffinityPolicy {
+public:
+    JumpHashPolicy();
+    std::string name() const override;
+
+protected:
+    void buildTable(const std::vector<std::string>& members) override;
+    int lookup(unsigned long long hash) const override;
+
+private:
+    std::vector<std::string> slots; ///< Bucket -> server id, stable across rebuilds.
+    std::vector<int> slotMember;    ///< Bucket -> index in the current member list.
+};
+
+#endif
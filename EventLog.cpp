@@ -0,0 +1,287 @@
+// EventLog.cpp
+
+#include "EventLog.h"
+#include <cstring>
+
+// file magic and format version
+const char EVENT_LOG_MAGIC[4] = {'L', 'B', 'E', 'V'};
+const unsigned char EVENT_LOG_VERSION = 1;
+// record kind that defines the next server index (not a LogEventKind)
+const unsigned char SERVER_DEFINITION = 0x40;
+
+// 7 bits per byte, high bit = more bytes follow
+static void putVarint(unsigned long long value, std::string& out) {
+    while (value >= 0x80) {
+        out += (char)((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += (char)value;
+}
+
+// signed -> unsigned so small negative numbers stay short
+static void putSigned(long long value, std::string& out) {
+    putVarint(((unsigned long long)value << 1) ^ (unsigned long long)(value >> 63), out);
+}
+
+// inverse of the zigzag mapping above
+static long long unzigzag(unsigned long long value) {
+    return (long long)(value >> 1) ^ -(long long)(value & 1);
+}
+
+// packed IP, most significant octet first
+static void putIp(uint32_t ip, std::string& out) {
+    out += (char)(ip >> 24);
+    out += (char)(ip >> 16);
+    out += (char)(ip >> 8);
+    out += (char)ip;
+}
+
+// which kinds name a server
+static bool hasServer(int kind) {
+    return kind == LOG_ASSIGNED || kind == LOG_PREEMPTED || kind == LOG_COMPLETED;
+}
+
+// which kinds carry the two IPs
+static bool hasIps(int kind) {
+    return kind == LOG_QUEUED || kind == LOG_ASSIGNED || kind == LOG_BLOCKED;
+}
+
+// which kinds carry a value
+static bool hasValue(int kind) {
+    return kind != LOG_BLOCKED && kind != LOG_SHED_FULL && kind != LOG_SHED_EARLY;
+}
+
+// nothing written until the first record
+EventLogEncoder::EventLogEncoder() {
+    started = false;
+    lastCycle = 0;
+    lastId = 0;
+}
+
+// header once, server definition if new, then the record itself
+void EventLogEncoder::encode(const LogRecord& record, std::string& out) {
+    if (!started) {
+        out.append(EVENT_LOG_MAGIC, sizeof(EVENT_LOG_MAGIC));
+        out += (char)EVENT_LOG_VERSION;
+        started = true;
+    }
+
+    if (record.kind == LOG_TEXT) {
+        out += (char)LOG_TEXT;
+        putVarint(record.length, out);
+        out.append(record.text, record.length);
+        out += (char)record.more;
+        return;
+    }
+
+    int server = hasServer(record.kind) ? serverIndex(record, out) : 0;
+    out += (char)record.kind;
+    putSigned((long long)record.cycle - lastCycle, out);
+    lastCycle = record.cycle;
+    if (record.kind == LOG_SCALED) {
+        putSigned(record.value, out);
+        putVarint(record.requestId, out);
+        return;
+    }
+
+    putSigned((long long)record.requestId - lastId, out);
+    lastId = record.requestId;
+    if (hasServer(record.kind)) {
+        putVarint(server, out);
+    }
+    if (hasIps(record.kind)) {
+        putIp(record.ipIn, out);
+        putIp(record.ipOut, out);
+    }
+    if (record.kind == LOG_QUEUED) {
+        out += record.jobType;
+    }
+    if (hasValue(record.kind)) {
+        putSigned(record.value, out);
+    }
+}
+
+// look up, or assign the next index and define it inline
+int EventLogEncoder::serverIndex(const LogRecord& record, std::string& out) {
+    std::string id(record.text, record.length);
+    std::unordered_map<std::string, int>::iterator it = servers.find(id);
+    if (it != servers.end()) {
+        return it->second;
+    }
+    int index = (int)servers.size();
+    servers[id] = index;
+    out += (char)SERVER_DEFINITION;
+    putVarint(id.size(), out);
+    out += id;
+    return index;
+}
+
+// check the header straight away
+EventLogDecoder::EventLogDecoder(const std::string& bytes) : data(bytes) {
+    pos = 0;
+    lastCycle = 0;
+    lastId = 0;
+    headerOk = data.size() >= 5 && memcmp(data.data(), EVENT_LOG_MAGIC, 4) == 0 && (unsigned char)data[4] == EVENT_LOG_VERSION;
+    if (headerOk) {
+        pos = 5;
+    }
+}
+
+// getter for the header check
+bool EventLogDecoder::valid() const {
+    return headerOk;
+}
+
+// mirror of EventLogEncoder::encode
+bool EventLogDecoder::next(LogRecord& record) {
+    if (!headerOk) {
+        return false;
+    }
+    record = LogRecord();
+    unsigned long long value = 0;
+    while (pos < data.size() && (unsigned char)data[pos] == SERVER_DEFINITION) {
+        pos++;
+        if (!readVarint(value) || pos + value > data.size()) {
+            return false;
+        }
+        servers.push_back(data.substr(pos, value));
+        pos += value;
+    }
+    if (pos >= data.size()) {
+        return false;
+    }
+
+    record.kind = (unsigned char)data[pos++];
+    if (record.kind == LOG_TEXT) {
+        if (!readVarint(value) || value > sizeof(record.text) || !readBytes(value, record.text)) {
+            return false;
+        }
+        record.length = (unsigned char)value;
+        char more = 0;
+        if (!readBytes(1, &more)) {
+            return false;
+        }
+        record.more = (unsigned char)more;
+        return true;
+    }
+
+    if (!readVarint(value)) {
+        return false;
+    }
+    lastCycle += (int)unzigzag(value);
+    record.cycle = lastCycle;
+    if (record.kind == LOG_SCALED) {
+        if (!readVarint(value)) {
+            return false;
+        }
+        record.value = (int)unzigzag(value);
+        if (!readVarint(value)) {
+            return false;
+        }
+        record.requestId = (int)value;
+        return true;
+    }
+
+    if (!readVarint(value)) {
+        return false;
+    }
+    lastId += (int)unzigzag(value);
+    record.requestId = lastId;
+    if (hasServer(record.kind)) {
+        if (!readVarint(value) || value >= servers.size()) {
+            return false;
+        }
+        const std::string& id = servers[value];
+        size_t length = id.size() < sizeof(record.text) ? id.size() : sizeof(record.text);
+        memcpy(record.text, id.data(), length);
+        record.length = (unsigned char)length;
+    }
+    if (hasIps(record.kind)) {
+        unsigned char ips[8];
+        if (!readBytes(8, (char*)ips)) {
+            return false;
+        }
+        record.ipIn = ((uint32_t)ips[0] << 24) | ((uint32_t)ips[1] << 16) | ((uint32_t)ips[2] << 8) | ips[3];
+        record.ipOut = ((uint32_t)ips[4] << 24) | ((uint32_t)ips[5] << 16) | ((uint32_t)ips[6] << 8) | ips[7];
+    }
+    if (record.kind == LOG_QUEUED && !readBytes(1, &record.jobType)) {
+        return false;
+    }
+    if (hasValue(record.kind)) {
+        if (!readVarint(value)) {
+            return false;
+        }
+        record.value = (int)unzigzag(value);
+    }
+    return true;
+}
+
+// event column of the CSV
+const char* EventLogDecoder::kindName(int kind) {
+    switch (kind) {
+    case LOG_QUEUED:
+        return "queued";
+    case LOG_ASSIGNED:
+        return "assigned";
+    case LOG_SHED_FULL:
+        return "shed_full";
+    case LOG_SHED_EARLY:
+        return "shed_early";
+    case LOG_CODEL_DROP:
+        return "codel_drop";
+    case LOG_TIMEOUT:
+        return "timeout";
+    case LOG_PREEMPTED:
+        return "preempted";
+    case LOG_COMPLETED:
+        return "completed";
+    case LOG_BLOCKED:
+        return "blocked";
+    case LOG_SCALED:
+        return "scale";
+    }
+    return "text";
+}
+
+// cycle,event,request_id,server,ip_in,ip_out,job_type,value
+void EventLogDecoder::formatCsv(const LogRecord& record, std::string& out) {
+    out += std::to_string(record.cycle) + ',' + kindName(record.kind) + ',';
+    // for scale events the id column holds the pool size
+    out += std::to_string(record.requestId) + ',';
+    out.append(record.text, hasServer(record.kind) ? record.length : 0);
+    out += ',';
+    for (int side = 0; side < 2; side++) {
+        uint32_t ip = side == 0 ? record.ipIn : record.ipOut;
+        if (hasIps(record.kind)) {
+            out += std::to_string(ip >> 24) + '.' + std::to_string((ip >> 16) & 0xFF) + '.' + std::to_string((ip >> 8) & 0xFF) + '.' + std::to_string(ip & 0xFF);
+        }
+        out += ',';
+    }
+    if (record.kind == LOG_QUEUED) {
+        out += record.jobType;
+    }
+    out += ',' + std::to_string(record.value) + '\n';
+}
+
+// little-endian base-128
+bool EventLogDecoder::readVarint(unsigned long long& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < data.size(); shift += 7) {
+        unsigned char byte = (unsigned char)data[pos++];
+        value |= (unsigned long long)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// raw bytes
+bool EventLogDecoder::readBytes(size_t count, char* out) {
+    if (pos + count > data.size()) {
+        return false;
+    }
+    memcpy(out, data.data() + pos, count);
+    pos += count;
+    return true;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file EventLog.h
+ * @brief Defines the compact binary event log: EventLogEncoder turns
+ *        LogRecords into bytes and EventLogDecoder turns them back.
+ *
+ * @author Karan Bhagat
+ * @date 2026
+ */
+
+#ifndef EVENTLOG_H
+#define EVENTLOG_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "AsyncLogger.h"
+
+/**
+ * @class EventLogEncoder
+ * @brief Writes LogRecords in the binary event log format.
+ *
+ * The stream starts with the 5-byte header @c "LBEV" + version. Each record
+ * is one kind byte followed by its fields:
+ *  - cycle as a zigzag varint delta from the previous record's cycle
+ *    (shard records can arrive slightly out of order);
+ *  - request id as a zigzag varint delta from the previous request id
+ *    (ids are near-sequential, so this is usually one byte);
+ *  - IPs as 4 raw bytes, the job type as 1 byte, and any count (service
+ *    time, wait, response, servers added) as a varint;
+ *  - servers as a varint index. The first time a server id appears it is
+ *    defined by a SERVER record (index implied, varint length + name).
+ *
+ * Text lines (banner, status, scale messages, summary) are stored as
+ * varint length + bytes, so the decoder can reproduce the text log in
+ * full. A request typically costs 25-35 bytes for its queued, assigned and
+ * completed records, against roughly 180 bytes of text.
+ *
+ * The encoder is stateful (deltas and the server table), so one stream
+ * needs one encoder, used from one thread at a time.
+ */
+class EventLogEncoder {
+public:
+    EventLogEncoder();
+
+    /**
+     * @brief Appends the binary form of @p record to @p out, preceded by
+     *        the header on the first call and a SERVER record for a new server id.
+     */
+    void encode(const LogRecord& record, std::string& out);
+
+private:
+    /** @brief Index of a server id, defining it in @p out the first time. */
+    int serverIndex(const LogRecord& record, std::string& out);
+
+    bool started;                                  ///< Header written.
+    int lastCycle;                                 ///< Cycle of the previous record.
+    int lastId;                                    ///< Request id of the previous request record.
+    std::unordered_map<std::string, int> servers;  ///< Server id -> index.
+};
+
+/**
+ * @class EventLogDecoder
+ * @brief Reads a binary event log back into LogRecords.
+ */
+class EventLogDecoder {
+public:
+    /**
+     * @brief Prepares to decode a whole log held in memory.
+     * @param data Contents of the log file.
+     */
+    explicit EventLogDecoder(const std::string& data);
+
+    /** @brief @c true if the data starts with a supported header. */
+    bool valid() const;
+
+    /**
+     * @brief Decodes the next event.
+     * @param record Output parameter; server ids are restored into @c text.
+     * @return @c false at the end of the data or on a truncated record.
+     */
+    bool next(LogRecord& record);
+
+    /**
+     * @brief Name of a record kind for CSV output.
+     * @param kind LogEventKind.
+     */
+    static const char* kindName(int kind);
+
+    /**
+     * @brief Appends one CSV row (cycle,event,request_id,server,ip_in,ip_out,job_type,value)
+     *        for a non-text record.
+     */
+    static void formatCsv(const LogRecord& record, std::string& out);
+
+private:
+    /** @brief Reads an unsigned varint; false if the data ran out. */
+    bool readVarint(unsigned long long& value);
+
+    /** @brief Reads @p count raw bytes into @p out; false if the data ran out. */
+    bool readBytes(size_t count, char* out);
+
+    const std::string& data;           ///< Whole log.
+    size_t pos;                        ///< Read offset.
+    bool headerOk;                     ///< Header check result.
+    int lastCycle;                     ///< Decoder copy of the encoder's deltas.
+    int lastId;                        ///< Decoder copy of the encoder's deltas.
+    std::vector<std::string> servers;  ///< Server ids by index.
+};
+
+#endif
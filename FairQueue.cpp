@@ -0,0 +1,100 @@
+// FairQueue.cpp
+
+#include "FairQueue.h"
+
+// one lane per weight (or a single lane), quanta scaled to the largest request
+FairQueue::FairQueue(QueueDiscipline discipline, int maxTime, int intervalWidth, const std::vector<double>& laneWeights) {
+    int laneCount = laneWeights.empty() ? 1 : (int)laneWeights.size();
+    for (int i = 0; i < laneCount; i++) {
+        lanes.push_back(RequestQueue(discipline, maxTime, intervalWidth));
+        long long share = laneWeights.empty() ? 1 : (long long)(laneWeights[i] * (maxTime < 1 ? 1 : maxTime) + 0.5);
+        quantum.push_back(share < 1 ? 1 : share);
+        deficit.push_back(0);
+    }
+    // start on the last lane so the first round begins at lane 0
+    current = laneCount - 1;
+    count = 0;
+}
+
+// add to the request's lane
+void FairQueue::push(const Request& request) {
+    int lane = lanes.size() == 1 ? 0 : laneFor(request.jobType);
+    lanes[lane].push(request);
+    count++;
+}
+
+// head of the lane the round robin is serving
+const Request& FairQueue::front() {
+    selectLane();
+    return lanes[current].front();
+}
+
+// dispatch the head and charge its work to the lane's deficit
+void FairQueue::pop() {
+    removeFront(true);
+}
+
+// the head leaves unserved, so the lane keeps its credit
+void FairQueue::discard() {
+    removeFront(false);
+}
+
+// shared by pop() and discard()
+void FairQueue::removeFront(bool charge) {
+    selectLane();
+    if (charge && lanes.size() > 1) {
+        deficit[current] -= lanes[current].front().timeRequired;
+    }
+    lanes[current].pop();
+    count--;
+    // an emptied lane forfeits leftover credit so it cannot burst later
+    if (lanes[current].empty()) {
+        deficit[current] = 0;
+    }
+}
+
+// expired requests were never served, so no lane is charged; emptied lanes lose their credit
+int FairQueue::removeExpired(int cycle, std::vector<Request>& expired) {
+    int removed = 0;
+    for (int lane = 0; lane < (int)lanes.size(); lane++) {
+        removed += lanes[lane].removeExpired(cycle, expired);
+        if (lanes[lane].empty()) {
+            deficit[lane] = 0;
+        }
+    }
+    count -= removed;
+    return removed;
+}
+
+// true if nothing is queued
+bool FairQueue::empty() const {
+    return count == 0;
+}
+
+// getter for queue depth
+int FairQueue::size() const {
+    return count;
+}
+
+// 'S' jobs go in the streaming lane, everything else in processing
+int FairQueue::laneFor(char jobType) {
+    return jobType == 'S' ? 1 : 0;
+}
+
+// standard DRR: visit lanes in turn, topping up each non-empty one by its quantum
+void FairQueue::selectLane() {
+    if (lanes.size() == 1) {
+        current = 0;
+        return;
+    }
+
+    while (lanes[current].empty() || deficit[current] < lanes[current].front().timeRequired) {
+        if (lanes[current].empty()) {
+            deficit[current] = 0;
+        }
+        current = (current + 1) % (int)lanes.size();
+        if (!lanes[current].empty()) {
+            deficit[current] += quantum[current];
+        }
+    }
+}
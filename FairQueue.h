@@ -0,0 +1,111 @@
+/**
+ * @file FairQueue.h
+ * @brief Defines the FairQueue class, which keeps one RequestQueue per job
+ *        type and shares dispatch between them by deficit round robin.
+ *
+ * @author Karan Bhagat
+ * @date 2026
+ */
+
+#ifndef FAIRQUEUE_H
+#define FAIRQUEUE_H
+
+#include <vector>
+
+#include "Request.h"
+#include "RequestQueue.h"
+
+/**
+ * @class FairQueue
+ * @brief Per-job-type lanes served by deficit round robin (DRR).
+ *
+ * Each job type ('P' processing, 'S' streaming) has its own lane, ordered by
+ * the shard's queue discipline. Each time the round robin visits a
+ * non-empty lane the lane earns a quantum of weight × maxTime work units,
+ * and it keeps dispatching while its deficit covers the timeRequired of
+ * its head request. Over any busy period each lane therefore receives
+ * server work in proportion to its weight, whatever the mix of request
+ * sizes, and a lane with no backlog accumulates no credit.
+ *
+ * With no weights the queue has a single lane and behaves exactly like
+ * one RequestQueue.
+ */
+class FairQueue {
+public:
+    /** @brief Number of lanes when fair queueing is enabled (P and S). */
+    static const int LANE_COUNT = 2;
+
+    /**
+     * @brief Constructs an empty queue.
+     * @param discipline    Order within each lane.
+     * @param maxTime       Largest request size, for the lane buckets and quanta.
+     * @param intervalWidth Size interval width for QUEUE_SIZE_INTERVAL.
+     * @param laneWeights   One weight per lane (see laneFor()); empty disables fair queueing.
+     */
+    FairQueue(QueueDiscipline discipline, int maxTime, int intervalWidth, const std::vector<double>& laneWeights);
+
+    /**
+     * @brief Adds a request to its job type's lane.
+     * @param request Request to enqueue.
+     */
+    void push(const Request& request);
+
+    /**
+     * @brief Returns the request that would be dispatched next.
+     *
+     * Advances the round robin if the current lane cannot afford its head,
+     * so it is not const; calling it repeatedly without pop() returns the
+     * same request.
+     *
+     * @return Reference valid until the next push() or pop(); queue must not be empty.
+     */
+    const Request& front();
+
+    /** @brief Removes the request returned by front() and charges its lane. */
+    void pop();
+
+    /**
+     * @brief Removes the request returned by front() without charging its lane.
+     *
+     * For requests that leave the queue without being served (timed out,
+     * shed or stolen by another shard), so their lane keeps its share.
+     */
+    void discard();
+
+    /**
+     * @brief Removes every expired request from every lane through each
+     *        lane's deadline index (see RequestQueue::removeExpired()).
+     * @param cycle   Current simulation cycle.
+     * @param expired Removed requests are appended here.
+     * @return Number of requests removed.
+     */
+    int removeExpired(int cycle, std::vector<Request>& expired);
+
+    /** @brief @c true when no requests are queued. */
+    bool empty() const;
+
+    /** @brief Number of queued requests across all lanes. */
+    int size() const;
+
+    /**
+     * @brief Maps a job type to its lane index.
+     * @param jobType Request::jobType.
+     * @return 1 for streaming ('S'), 0 otherwise.
+     */
+    static int laneFor(char jobType);
+
+private:
+    std::vector<RequestQueue> lanes; ///< One queue per lane.
+    std::vector<long long> quantum;  ///< Work units a lane earns per round.
+    std::vector<long long> deficit;  ///< Work units a lane may still dispatch this round.
+    int current;                     ///< Lane being served.
+    int count;                       ///< Total queued requests.
+
+    /** @brief Moves @c current to the next lane whose deficit covers its head request. */
+    void selectLane();
+
+    /** @brief Removes the current lane's head, charging its work to the lane if @p charge. */
+    void removeFront(bool charge);
+};
+
+#endif
@@ -0,0 +1,104 @@
+// Histogram.cpp
+
+#include "Histogram.h"
+#include <algorithm>
+
+// empty histogram, every bucket allocated up front
+Histogram::Histogram() : counts(BUCKET_COUNT, 0) {
+    total = 0;
+    sum = 0;
+    maxValue = 0;
+}
+
+// bump the counter of the value's bucket
+void Histogram::record(int value) {
+    if (value < 0) {
+        value = 0;
+    }
+    counts[bucketFor(value)]++;
+    total++;
+    sum += value;
+    if (value > maxValue) {
+        maxValue = value;
+    }
+}
+
+// add the other histogram's counters to ours (same layout, bucket by bucket; none are set above its max)
+void Histogram::merge(const Histogram& other) {
+    int last = bucketFor(other.maxValue);
+    for (int b = 0; b <= last; b++) {
+        counts[b] += other.counts[b];
+    }
+    total += other.total;
+    sum += other.sum;
+    if (other.maxValue > maxValue) {
+        maxValue = other.maxValue;
+    }
+}
+
+// zero the counters in place, up to the max's bucket
+void Histogram::clear() {
+    std::fill(counts.begin(), counts.begin() + bucketFor(maxValue) + 1, 0);
+    total = 0;
+    sum = 0;
+    maxValue = 0;
+}
+
+// getter for number of samples
+long long Histogram::count() const {
+    return total;
+}
+
+// average sample value
+double Histogram::mean() const {
+    return total > 0 ? (double)sum / total : 0.0;
+}
+
+// walk the counters until we've covered p percent of the samples
+int Histogram::percentile(double p) const {
+    if (total == 0) {
+        return 0;
+    }
+
+    long long rank = (long long)(p / 100.0 * total + 0.5);
+    if (rank < 1) {
+        rank = 1;
+    }
+
+    long long seen = 0;
+    for (int b = 0; b < BUCKET_COUNT; b++) {
+        seen += counts[b];
+        if (seen >= rank) {
+            int high = bucketHigh(b);
+            return high < maxValue ? high : maxValue;
+        }
+    }
+    return maxValue;
+}
+
+// getter for the largest sample
+int Histogram::max() const {
+    return maxValue;
+}
+
+// exact below EXACT_LIMIT, then the top 8 bits of the value pick the bucket
+int Histogram::bucketFor(int value) {
+    if (value < EXACT_LIMIT) {
+        return value;
+    }
+    int msb = 31 - __builtin_clz((unsigned)value);
+    int shift = msb - 7;
+    return EXACT_LIMIT + (msb - 8) * SUB_BUCKETS + ((value >> shift) - SUB_BUCKETS);
+}
+
+// inverse of bucketFor: last value of the bucket's range
+int Histogram::bucketHigh(int bucket) {
+    if (bucket < EXACT_LIMIT) {
+        return bucket;
+    }
+    int octave = (bucket - EXACT_LIMIT) / SUB_BUCKETS;
+    int sub = (bucket - EXACT_LIMIT) % SUB_BUCKETS;
+    int shift = octave + 1;
+    long long high = ((long long)(sub + SUB_BUCKETS + 1) << shift) - 1;
+    return high > 0x7FFFFFFF ? 0x7FFFFFFF : (int)high;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file Histogram.h
+ * @brief Defines the Histogram class used to record per-request latencies
+ *        (in clock cycles) and report means and percentiles.
+ *
+ * @author Karan Bhagat
+ * @date 2026
+ */
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <vector>
+
+/**
+ * @class Histogram
+ * @brief HDR-style log-bucketed histogram over non-negative integer values.
+ *
+ * Values below 256 get a bucket each. Above that every power-of-two range
+ * is split into 128 equal buckets, so a bucket is never wider than 1/128
+ * of the values in it and a percentile is within 0.8% of the exact one
+ * (reported as the bucket's upper bound, capped at max()). The bucket
+ * array has a fixed size covering the whole int range (3200 counters), so
+ * memory is constant however long the run, and record() is a bit scan and
+ * an increment. The count, mean and max are exact.
+ *
+ * Histograms can be merged, which lets each shard record into its own
+ * instance without locking and have the results combined at the end of a
+ * run, or results of several runs be pooled.
+ */
+class Histogram {
+public:
+    /// Values below this are counted exactly.
+    static const int EXACT_LIMIT = 256;
+    /// Buckets per power-of-two range above EXACT_LIMIT.
+    static const int SUB_BUCKETS = 128;
+    /// Total buckets: the exact range plus 23 octaves (256 .. INT_MAX).
+    static const int BUCKET_COUNT = EXACT_LIMIT + 23 * SUB_BUCKETS;
+
+    /**
+     * @brief Constructs an empty histogram.
+     */
+    Histogram();
+
+    /**
+     * @brief Adds one sample.
+     * @param value Sample to record; negative values are clamped to 0.
+     */
+    void record(int value);
+
+    /**
+     * @brief Adds every sample of @p other to this histogram.
+     * @param other Histogram to merge in.
+     */
+    void merge(const Histogram& other);
+
+    /** @brief Removes every sample, keeping the buckets allocated. */
+    void clear();
+
+    /** @brief Number of samples recorded. */
+    long long count() const;
+
+    /** @brief Arithmetic mean of all samples (0 if empty). */
+    double mean() const;
+
+    /**
+     * @brief Returns the smallest value that at least @p p percent of the
+     *        samples are less than or equal to, to bucket precision.
+     * @param p Percentile in [0, 100].
+     * @return The percentile value, or 0 if the histogram is empty.
+     */
+    int percentile(double p) const;
+
+    /** @brief Largest sample recorded (0 if empty). */
+    int max() const;
+
+private:
+    /** @brief Bucket a value falls in. */
+    static int bucketFor(int value);
+
+    /** @brief Largest value that falls in @p bucket. */
+    static int bucketHigh(int bucket);
+
+    std::vector<long long> counts; ///< Samples per bucket (BUCKET_COUNT, allocated once).
+    long long total;               ///< Number of samples.
+    long long sum;                 ///< Sum of all samples, for the mean.
+    int maxValue;                  ///< Largest sample seen.
+};
+
+#endif
@@ -1,28 +1,130 @@
 // LoadBalancer.cpp
 
 #include "LoadBalancer.h"
+#include <chrono>
+#include <cmath>
 #include <cstdlib>
 #include <ctime>
 #include <iostream>
-
-// ANSI color codes for terminal output
-#define RESET  "\033[0m"
-#define CYAN   "\033[36m"
-#define GREEN  "\033[32m"
-#define YELLOW "\033[33m"
-#define RED    "\033[31m"
-
-const int MIN_QUEUE_PER_SERVER = 50;
-const int MAX_QUEUE_PER_SERVER = 80;
+#include <sstream>
 
 // constructor - copy config, set up blocker, open log, seed RNG
 LoadBalancer::LoadBalancer(const Config& cfg, const IPBlocker& blocker) {
     config = cfg;
     ipBlocker = new IPBlocker(blocker);
-    logFile.open(config.logFilePath);
+    eventEncoder = nullptr;
+    if (config.logFormat == "binary") {
+        logFile.open(config.logFilePath, std::ios::out | std::ios::binary);
+        eventEncoder = new EventLogEncoder();
+    } else {
+        logFile.open(config.logFilePath);
+    }
+    asyncLog = nullptr;
+    logLevel = LOG_TRACE;
+    if (!AsyncLogger::parseLevel(config.logLevel, logLevel)) {
+        config.logLevel = "trace";
+    }
+    LogLevel consoleLevel = LOG_REQUEST;
+    if (!AsyncLogger::parseLevel(config.consoleLevel, consoleLevel)) {
+        config.consoleLevel = "request";
+    }
+    console = new ConsoleSink(std::cout, consoleLevel, config.consoleWindow, config.consoleBurst);
+    logTag = "";
+    timeSeries = nullptr;
+    metrics = nullptr;
+    LogOverflow overflow = LOG_OVERFLOW_BLOCK;
+    if (!AsyncLogger::parseOverflow(config.logOverflow, overflow)) {
+        config.logOverflow = "block";
+    }
+    if (config.logAsync && logFile.is_open()) {
+        asyncLog = new AsyncLogger(logFile, config.logRingSize, overflow, eventEncoder);
+    }
     currentTime = 0;
     nextRequestId = 1;
-    cooldownTimer = 0;
+    nextShard = 0;
+    routeByClient = false;
+    timeoutRng = 0x9E3779B97F4A7C15ULL ^ config.seed;
+    if (timeoutRng == 0) {
+        timeoutRng = 1;
+    }
+    serverCount = 0;
+    nextServerId = 1;
+    drainingServers = 0;
+    cycleArrivals = 0;
+    cycleArrivalWork = 0;
+    cycleCompleted = 0;
+    admittedWork = 0;
+
+    capacity = 0.0;
+    serverMode = config.serverMode == "ps" ? SERVICE_PS : SERVICE_FCFS;
+    cachePolicy = CACHE_NONE;
+    if (!ResponseCache::parsePolicy(config.cachePolicy, cachePolicy)) {
+        config.cachePolicy = "none";
+    }
+    stats.cachePolicy = config.cachePolicy;
+    types = config.serverTypes;
+    if (types.empty()) {
+        ServerType single;
+        single.name = "default";
+        single.speed = 1.0;
+        single.count = config.initialServers;
+        types.push_back(single);
+    }
+    for (int i = 0; i < (int)types.size(); i++) {
+        ServerTypeStats typeStats;
+        typeStats.name = types[i].name;
+        typeStats.speed = types[i].speed;
+        stats.serverTypes.push_back(typeStats);
+    }
+
+    if (config.workerThreads < 1) {
+        config.workerThreads = 1;
+    }
+    QueueDiscipline discipline = QUEUE_FIFO;
+    if (!RequestQueue::parseDiscipline(config.queueDiscipline, discipline)) {
+        config.queueDiscipline = "fifo";
+    }
+    stats.queueDiscipline = config.queueDiscipline;
+    stats.fairQueueing = !config.jobTypeWeights.empty();
+    for (int i = 0; i < config.workerThreads; i++) {
+        DispatchPolicy* policy = DispatchPolicy::create(config.dispatchPolicy, config.dispatchChoices, config.seed + i);
+        if (policy == nullptr) {
+            policy = new FirstIdlePolicy();
+        }
+        shards.push_back(new Shard(policy, discipline, config.maxRequestTime * config.streamTimeMultiplier, config.queueIntervalWidth, config.jobTypeWeights));
+        stats.dispatchPolicy = policy->name();
+        routeByClient = policy->clientAffinity() && config.workerThreads > 1;
+    }
+    workers = new WorkerPool(config.workerThreads);
+
+    ShedPolicy shedPolicy = SHED_DROP_TAIL;
+    if (!AdmissionControl::parsePolicy(config.shedPolicy, shedPolicy)) {
+        config.shedPolicy = "drop_tail";
+    }
+    stats.shedPolicy = config.shedPolicy;
+    admission = new AdmissionControl(shedPolicy, config.queueCapacity, config.redMaxProbability, config.seed);
+    scaler = ScalingPolicy::create(config);
+    if (scaler == nullptr) {
+        config.scalingPolicy = "threshold";
+        scaler = new ThresholdScaling(config.scalingCooldownCycles);
+    }
+    stats.scalingPolicy = scaler->name();
+    for (int i = 0; shedPolicy == SHED_CODEL && i < (int)shards.size(); i++) {
+        shards[i]->enableCoDel(config.codelTarget, config.codelInterval);
+    }
+    stats.workerThreads = config.workerThreads;
+    // a fixed client population, so the same clients come back and affinity means something
+    unsigned long long clientRng = 0x2545F4914F6CDD1DULL ^ config.seed;
+    for (int i = 0; i < config.clientCount; i++) {
+        clientRng ^= clientRng << 13;
+        clientRng ^= clientRng >> 7;
+        clientRng ^= clientRng << 17;
+        std::string ip;
+        for (int octet = 0; octet < 4; octet++) {
+            ip += (octet > 0 ? "." : "") + std::to_string((clientRng >> (octet * 8)) & 0xFF);
+        }
+        clientIps.push_back(ip);
+    }
     if (config.seed == 0) {
         srand((unsigned int)time(nullptr));
     } else {
@@ -30,16 +132,31 @@ LoadBalancer::LoadBalancer(const Config& cfg, const IPBlocker& blocker) {
     }
 }
 
-// destructor - free servers, blocker, close log
+// destructor - stop workers, free shards (and their servers), blocker, close log
 LoadBalancer::~LoadBalancer() {
-    for (int i = 0; i < (int)servers.size(); i++) {
-        delete servers[i];
+    delete asyncLog;
+    asyncLog = nullptr;
+    delete workers;
+    delete admission;
+    delete scaler;
+    workers = nullptr;
+
+    for (int i = 0; i < (int)shards.size(); i++) {
+        delete shards[i];
     }
-    servers.clear();
+    shards.clear();
 
     delete ipBlocker;
     ipBlocker = nullptr;
 
+    delete eventEncoder;
+    eventEncoder = nullptr;
+    delete console;
+    console = nullptr;
+    delete timeSeries;
+    timeSeries = nullptr;
+    delete metrics;
+    metrics = nullptr;
     if (logFile.is_open()) {
         logFile.close();
     }
@@ -47,40 +164,141 @@ LoadBalancer::~LoadBalancer() {
 
 // make a new random request with the next available ID
 Request LoadBalancer::generateRequest() {
-    return Request::randomRequest(nextRequestId++, config.minRequestTime, config.maxRequestTime);
+    Request request = Request::randomRequest(nextRequestId++, config.minRequestTime, config.maxRequestTime);
+    int client = 0;
+    if (!clientIps.empty()) {
+        client = rand() % clientIps.size();
+        request.ipIn = clientIps[client];
+    }
+    // each client has its own content_count objects, so a client's repeat requests can hit
+    if (cachePolicy != CACHE_NONE) {
+        if (config.cacheKey == "ip_out") {
+            request.contentKey = (long long)(AffinityPolicy::hashKey(request.ipOut, 0) >> 1);
+        } else {
+            request.contentKey = (long long)client * config.contentCount + rand() % config.contentCount;
+        }
+    }
+    if (request.jobType == 'S') {
+        request.timeRequired *= config.streamTimeMultiplier;
+    }
+    if (config.requestTimeout > 0) {
+        request.timeout = drawTimeout();
+    }
+    return request;
 }
 
-// checks if request IP is blocked, otherwise pushes it onto the queue
+// fixed, uniform around the mean, or exponential (memoryless patience)
+int LoadBalancer::drawTimeout() {
+    timeoutRng ^= timeoutRng << 13;
+    timeoutRng ^= timeoutRng >> 7;
+    timeoutRng ^= timeoutRng << 17;
+    double u = (double)(timeoutRng >> 11) / 9007199254740992.0;
+
+    double timeout = config.requestTimeout;
+    if (config.requestTimeoutDist == "uniform") {
+        timeout *= 0.5 + u;
+    } else if (config.requestTimeoutDist == "exponential") {
+        timeout *= -std::log(1.0 - u);
+    }
+    return timeout < 1.0 ? 1 : (int)(timeout + 0.5);
+}
+
+// checks if request IP is blocked, otherwise pushes it onto the next shard's queue
 void LoadBalancer::addRequest(const Request& request) {
+    admitRequest(request, ipBlocker->isBlocked(request.ipIn));
+}
+
+// counts a request, logs it, and queues it unless the firewall rejected it
+void LoadBalancer::admitRequest(const Request& request, bool blocked) {
     stats.generatedRequests++;
-    if (ipBlocker->isBlocked(request.ipIn)) {
+    if (blocked) {
         stats.blockedRequests++;
-        std::string blockMsg = "Request #" + std::to_string(request.id) + " BLOCKED | src=" + request.ipIn + " dst=" + request.ipOut;
-        writeLog("BLOCK", YELLOW, blockMsg);
+        if constexpr (LOG_COMPILED_LEVEL >= LOG_REQUEST) {
+            // console text (unless rate-limited), a structured record for the file
+            if (console->admit(LOG_REQUEST, "BLOCK", YELLOW)) {
+                beginLog("BLOCK") << "Request #" << request.id << " BLOCKED | src=" << request.ipIn << " dst=" << request.ipOut;
+                console->write(YELLOW, logMessage.view());
+            }
+            if (logLevel >= LOG_REQUEST && logFile.is_open()) {
+                logEvent(AsyncLogger::makeRecord(LOG_BLOCKED, currentTime, request, 0, ""));
+            }
+        }
+        return;
+    }
+
+    // RED stays out of the initial fill, which is a preloaded backlog rather than arrivals
+    AdmissionDecision decision = admission->decide(queueSize(), currentTime > 0);
+    if (decision == REJECT_FULL || decision == REJECT_EARLY) {
+        if (decision == REJECT_FULL) {
+            stats.shedFull++;
+        } else {
+            stats.shedEarly++;
+        }
+        if constexpr (LOG_COMPILED_LEVEL >= LOG_REQUEST) {
+            if (logLevel >= LOG_REQUEST && logFile.is_open()) {
+                logEvent(AsyncLogger::makeRecord(decision == REJECT_FULL ? LOG_SHED_FULL : LOG_SHED_EARLY, currentTime, request, 0, ""));
+            }
+        }
         return;
     }
+    if (decision == ADMIT_DROP_OLDEST) {
+        int longest = 0;
+        for (int i = 1; i < (int)shards.size(); i++) {
+            if (shards[i]->queueSize() > shards[longest]->queueSize()) {
+                longest = i;
+            }
+        }
+        if (shards[longest]->dropHead()) {
+            stats.shedOldest++;
+        }
+    }
 
-    requestQueue.push(request);
+    Request queued = request;
+    queued.enqueueTime = currentTime;
+    if (routeByClient) {
+        // a different seed from the in-shard lookup, so shard and server choices are independent
+        shards[AffinityPolicy::hashKey(queued.ipIn, 3) % shards.size()]->enqueue(queued);
+    } else {
+        shards[nextShard]->enqueue(queued);
+        nextShard = (nextShard + 1) % (int)shards.size();
+    }
     stats.acceptedRequests++;
-    if (logFile.is_open()) {
-        logFile << "[QUEUED] Request #" << request.id << " | " << request.ipIn << " -> " << request.ipOut << " | type=" << request.jobType << " time=" << request.timeRequired << '\n';
+    cycleArrivals++;
+    cycleArrivalWork += request.timeRequired;
+    admittedWork += request.timeRequired;
+    if constexpr (LOG_COMPILED_LEVEL >= LOG_REQUEST) {
+        if (logLevel >= LOG_REQUEST && logFile.is_open()) {
+            logEvent(AsyncLogger::makeRecord(LOG_QUEUED, currentTime, request, request.timeRequired, ""));
+        }
     }
 }
 
 // fill the queue before the simulation starts (servers * multiplier)
 void LoadBalancer::fillInitialQueue() {
     int targetQueueSize = config.initialServers * config.initialQueueMultiplier;
-    while ((int)requestQueue.size() < targetQueueSize) {
+    if (admission->capacity() > 0 && targetQueueSize > admission->capacity()) {
+        targetQueueSize = admission->capacity();
+    }
+    while (queueSize() < targetQueueSize) {
         addRequest(generateRequest());
     }
 
-    stats.peakQueueSize = (int)requestQueue.size();
+    stats.peakQueueSize = queueSize();
+}
+
+// randomly generate 0 or 1 new requests for this cycle
+void LoadBalancer::generateArrivals(std::vector<Request>& out) {
+    if (rand() % 2 == 0) {
+        out.push_back(generateRequest());
+    }
 }
 
 // randomly add 0 or 1 new requests each cycle
 void LoadBalancer::randomAddNewRequests() {
-    if (rand() % 2 == 0) {
-        addRequest(generateRequest());
+    arrivals.clear();
+    generateArrivals(arrivals);
+    for (int i = 0; i < (int)arrivals.size(); i++) {
+        addRequest(arrivals[i]);
     }
 }
 
@@ -90,162 +308,793 @@ void LoadBalancer::initializeServers() {
         config.initialServers = 1;
     }
 
+    // smooth weighted round-robin over the type counts keeps the mix interleaved
+    std::vector<int> credit(types.size(), 0);
+    int totalCount = 0;
+    for (int t = 0; t < (int)types.size(); t++) {
+        totalCount += types[t].count;
+    }
+
     for (int index = 0; index < config.initialServers; index++) {
-        addServer();
+        int chosen = 0;
+        for (int t = 0; t < (int)types.size(); t++) {
+            credit[t] += types[t].count;
+            if (credit[t] > credit[chosen]) {
+                chosen = t;
+            }
+        }
+        credit[chosen] -= totalCount;
+        addServerOfType(chosen, false);
     }
 }
 
-// create a new web server and add it to the pool
+// add a server of the default scale-up type
 void LoadBalancer::addServer() {
-    std::string id = std::to_string(servers.size() + 1);
-    servers.push_back(new WebServer(id));
+    addServerOfType(chooseServerType(0.0), true);
+}
+
+// create a new web server of the given type and give it to the smallest shard
+void LoadBalancer::addServerOfType(int type, bool cold) {
+    int target = 0;
+    for (int i = 1; i < (int)shards.size(); i++) {
+        if (shards[i]->serverCount() < shards[target]->serverCount()) {
+            target = i;
+        }
+    }
+
+    std::string id = std::to_string(nextServerId++);
+    if (!config.serverTypes.empty()) {
+        id = types[type].name + "-" + id;
+    }
+    WebServer* server = new WebServer(id, config.serverSlots, serverMode, types[type].speed, type);
+    if (cold) {
+        server->coldStart(config.serverBootCycles, config.serverWarmupCycles, config.warmupSpeed);
+    }
+    if (cachePolicy != CACHE_NONE) {
+        server->enableCache(cachePolicy, config.cacheCapacity, config.cacheHitFactor);
+    }
+    shards[target]->addServer(server);
+    serverCount++;
+    capacity += server->serviceRate();
+}
+
+// named type if configured, else the smallest type that covers the need
+int LoadBalancer::chooseServerType(double neededCapacity) const {
+    for (int t = 0; t < (int)types.size(); t++) {
+        if (types[t].name == config.scaleUpType) {
+            return t;
+        }
+    }
+
+    int smallestCovering = -1;
+    int largest = 0;
+    for (int t = 0; t < (int)types.size(); t++) {
+        if (types[t].speed > types[largest].speed) {
+            largest = t;
+        }
+        double typeCapacity = types[t].speed * (serverMode == SERVICE_FCFS ? config.serverSlots : 1);
+        if (typeCapacity >= neededCapacity && (smallestCovering == -1 || types[t].speed < types[smallestCovering].speed)) {
+            smallestCovering = t;
+        }
+    }
+    return smallestCovering != -1 ? smallestCovering : largest;
+}
+
+// fold one server's counters into its type's totals
+void LoadBalancer::recordServerType(const WebServer* server) {
+    ServerTypeStats& typeStats = stats.serverTypes[server->typeIndex()];
+    typeStats.completed += server->completedCount();
+    typeStats.busyTime += server->busyTime();
+    typeStats.lifetimeTicks += server->lifetimeTicks();
+    stats.serverLoad.add(server->id(), server->busyTime(), server->lifetimeTicks(), server->completedCount());
+    stats.cacheHits += server->cacheHits();
+    stats.cacheLookups += server->cacheLookups();
 }
 
-// find an available server to remove (search from back to front)
+// remove one idle server
 bool LoadBalancer::removeServer() {
-    for (int i = (int)servers.size() - 1; i >= 0; i--) {
-        if (servers[i]->isAvailable()) {
-            WebServer* target = servers[i];
-            servers.erase(servers.begin() + i);
-            delete target;
-            return true;
+    return removeServers(1) == 1;
+}
+
+// add a batch, picking each server's type from what is still needed
+int LoadBalancer::addServers(int count, double neededCapacity) {
+    int type = 0;
+    for (int i = 0; i < count; i++) {
+        type = chooseServerType(neededCapacity);
+        double before = serviceCapacity();
+        addServerOfType(type, true);
+        neededCapacity -= serviceCapacity() - before;
+        stats.addedServers++;
+        stats.serverTypes[type].addedServers++;
+    }
+    return type;
+}
+
+// remove a batch of idle servers, trying the largest shard first
+int LoadBalancer::removeServers(int count) {
+    int largest = 0;
+    for (int i = 1; i < (int)shards.size(); i++) {
+        if (shards[i]->serverCount() > shards[largest]->serverCount()) {
+            largest = i;
+        }
+    }
+
+    std::vector<WebServer*> removed;
+    for (int offset = 0; offset < (int)shards.size() && (int)removed.size() < count; offset++) {
+        int i = (largest + offset) % (int)shards.size();
+        shards[i]->removeIdleServers(count - (int)removed.size(), removed);
+    }
+
+    for (int i = 0; i < (int)removed.size(); i++) {
+        serverCount--;
+        capacity -= removed[i]->serviceRate();
+        stats.removedServers++;
+        stats.serverTypes[removed[i]->typeIndex()].removedServers++;
+        recordServerType(removed[i]);
+        delete removed[i];
+    }
+
+    int shortfall = count - (int)removed.size();
+    if (shortfall == 0) {
+        return count;
+    }
+    stats.scaleDownBlocked++;
+    stats.scaleDownShortfall += shortfall;
+    if (!config.scaleDownDrain) {
+        return (int)removed.size();
+    }
+
+    // not enough idle servers: the rest stop taking work and leave when empty
+    std::vector<WebServer*> marked;
+    for (int offset = 0; offset < (int)shards.size() && (int)marked.size() < shortfall; offset++) {
+        int i = (largest + offset) % (int)shards.size();
+        shards[i]->drainBusyServers(shortfall - (int)marked.size(), currentTime, marked);
+    }
+    for (int i = 0; i < (int)marked.size(); i++) {
+        serverCount--;
+        drainingServers++;
+        capacity -= marked[i]->serviceRate();
+        stats.removedServers++;
+        stats.serverTypes[marked[i]->typeIndex()].removedServers++;
+    }
+    return (int)(removed.size() + marked.size());
+}
+
+// free the servers whose drain finished this cycle
+void LoadBalancer::retireDrained() {
+    std::vector<WebServer*> done;
+    for (int i = 0; i < (int)shards.size(); i++) {
+        shards[i]->takeRetired(done);
+    }
+    for (int i = 0; i < (int)done.size(); i++) {
+        drainingServers--;
+        stats.drainedServers++;
+        if (logLevel >= LOG_SCALE && logFile.is_open()) {
+            beginLog("DRAINED") << "Server " << done[i]->id() << " retired after draining for " << currentTime + 1 - done[i]->drainStartCycle() << " cycles";
+            logLine(logMessage.view());
+        }
+        recordServerType(done[i]);
+        delete done[i];
+    }
+}
+
+// scaling capacity of the whole pool
+double LoadBalancer::serviceCapacity() const {
+    return capacity;
+}
+
+// servers not yet taking work, over all shards
+int LoadBalancer::pendingServers() const {
+    int total = 0;
+    for (int i = 0; i < (int)shards.size(); i++) {
+        total += shards[i]->provisioningCount();
+    }
+    return total;
+}
+
+// total queued requests over all shards
+int LoadBalancer::queueSize() const {
+    int total = 0;
+    for (int i = 0; i < (int)shards.size(); i++) {
+        total += shards[i]->queueSize();
+    }
+    return total;
+}
+
+// shards with free slots take the oldest requests from the most backed-up shard
+void LoadBalancer::stealWork() {
+    if (shards.size() < 2) {
+        return;
+    }
+
+    for (int t = 0; t < (int)shards.size(); t++) {
+        Shard* thief = shards[t];
+        int deficit = thief->freeSlotCount() - thief->queueSize();
+        while (deficit > 0) {
+            int victim = -1;
+            int bestSurplus = 0;
+            for (int v = 0; v < (int)shards.size(); v++) {
+                int surplus = shards[v]->queueSize() - shards[v]->freeSlotCount();
+                if (v != t && surplus > bestSurplus) {
+                    bestSurplus = surplus;
+                    victim = v;
+                }
+            }
+            if (victim == -1) {
+                return;
+            }
+
+            int moved = thief->stealFrom(*shards[victim], deficit < bestSurplus ? deficit : bestSurplus);
+            stats.stolenRequests += moved;
+            deficit -= moved;
         }
     }
-    return false;
 }
 
 // check queue vs thresholds and add/remove servers if needed
 void LoadBalancer::balanceLoad() {
-    if (cooldownTimer > 0) {
-        cooldownTimer--;
-        return;
+    ScalingSnapshot snapshot;
+    snapshot.cycle = currentTime;
+    snapshot.queued = queueSize();
+    snapshot.servers = serverCount;
+    snapshot.capacity = serviceCapacity();
+    for (int i = 0; i < (int)shards.size(); i++) {
+        snapshot.pendingServers += shards[i]->provisioningCount();
+        snapshot.pendingCapacity += shards[i]->provisioningCapacity();
     }
+    snapshot.arrivals = cycleArrivals;
+    snapshot.arrivalWork = cycleArrivalWork;
+    snapshot.completed = cycleCompleted;
+    snapshot.meanWork = stats.acceptedRequests > 0 ? (double)admittedWork / stats.acceptedRequests : 0.0;
 
-    int serverCount = (int)servers.size();
-    int queueSize = (int)requestQueue.size();
-    
-    int lowerThreshold = MIN_QUEUE_PER_SERVER * serverCount;
-    int upperThreshold = MAX_QUEUE_PER_SERVER * serverCount;
+    ScalingDecision decision = scaler->decide(snapshot);
+    bool proposed = decision.delta != 0;
+    // pool bounds apply to every policy; a clipped batch still counts as the policy's event
+    if (config.maxServers > 0 && serverCount + decision.delta > config.maxServers) {
+        decision.delta = config.maxServers - serverCount > 0 ? config.maxServers - serverCount : 0;
+    }
+    if (decision.delta < 0 && serverCount + decision.delta < config.minServers) {
+        decision.delta = config.minServers - serverCount < 0 ? config.minServers - serverCount : 0;
+    }
 
-    if (queueSize > upperThreshold) {
-        addServer();
-        stats.addedServers++;
-        cooldownTimer = config.scalingCooldownCycles;
-        std::string scaleMsg = "Cycle " + std::to_string(currentTime) + ": queue=" + std::to_string(queueSize) + " exceeded max threshold=" + std::to_string(upperThreshold) + ", added 1 server (now " + std::to_string(servers.size()) + ")";
-        writeLog("SCALE UP", GREEN, scaleMsg);
-    } else if (queueSize < lowerThreshold && serverCount > 1) {
-        if (removeServer()) {
-            stats.removedServers++;
-            cooldownTimer = config.scalingCooldownCycles;
-            std::string scaleMsg = "Cycle " + std::to_string(currentTime) + ": queue=" + std::to_string(queueSize) + " below min threshold=" + std::to_string(lowerThreshold) + ", removed 1 server (now " + std::to_string(servers.size()) + ")";
-            writeLog("SCALE DOWN", RED, scaleMsg);
+    if (decision.delta > 0) {
+        int type = addServers(decision.delta, decision.neededCapacity);
+        stats.scaleUpEvents++;
+        // the reason reflects the policy as it decided, before onScaled() updates it
+        if (logs(LOG_SCALE)) {
+            LogBuffer& msg = beginLog("SCALE UP") << "Cycle " << currentTime << ": ";
+            scaler->reason(msg);
+            msg << ", added ";
+            if (decision.delta > 1) {
+                msg << decision.delta << " servers";
+            } else if (config.serverTypes.empty()) {
+                msg << "1 server";
+            } else {
+                msg << "1 " << types[type].name << " server";
+            }
+            msg << " (now " << serverCount << ")";
+            writeLog(LOG_SCALE, GREEN);
+        }
+        scaler->onScaled(decision.delta);
+        logScale(decision.delta);
+    } else if (decision.delta < 0) {
+        int drainingBefore = drainingServers;
+        int removed = removeServers(-decision.delta);
+        if (removed > 0) {
+            stats.scaleDownEvents++;
+            int drained = drainingServers - drainingBefore;
+            if (logs(LOG_SCALE)) {
+                LogBuffer& msg = beginLog("SCALE DOWN") << "Cycle " << currentTime << ": ";
+                scaler->reason(msg);
+                msg << ", removed " << removed - drained << (removed - drained == 1 ? " server" : " servers");
+                if (drained > 0) {
+                    msg << ", draining " << drained;
+                }
+                msg << " (now " << serverCount << ")";
+                writeLog(LOG_SCALE, RED);
+            }
+            logScale(-removed);
         }
+        scaler->onScaled(-removed);
+    } else if (proposed) {
+        // clipped away entirely by the pool bounds
+        scaler->onScaled(0);
     }
 }
 
-// one clock cycle: give idle servers work, then tick all busy servers
+// one clock cycle: rebalance shards, tick them all, then collect results in order
 void LoadBalancer::processTick() {
-    for (int i = 0; i < (int)servers.size(); i++) {
-        if (requestQueue.empty()) {
-            break;
-        }
+    stealWork();
+
+    LogLevel fileLevel = logFile.is_open() ? logLevel : LOG_OFF;
+    int cycle = currentTime;
+    workers->run((int)shards.size(), [this, cycle, fileLevel](int i) {
+        shards[i]->processTick(cycle, fileLevel);
+    });
 
-        if (servers[i]->isAvailable()) {
-            Request next = requestQueue.front();
-            requestQueue.pop();
-            // file-only dispatch log
-            if (logFile.is_open()) {
-                logFile << "[ASSIGNED] Request #" << next.id << " -> server " << servers[i]->id() << " | " << next.ipIn << " -> " << next.ipOut << " | time=" << next.timeRequired << '\n';
+    tickEvents.clear();
+    cycleCompleted = 0;
+    for (int i = 0; i < (int)shards.size(); i++) {
+        cycleCompleted += shards[i]->completedThisTick();
+        const std::vector<int>& waits = shards[i]->lastTickWaits();
+        for (int j = 0; j < (int)waits.size(); j++) {
+            scaler->recordWait(waits[j]);
+        }
+        stats.completedRequests += shards[i]->completedThisTick();
+        shards[i]->drainLog(tickEvents);
+    }
+    // file-only dispatch log
+    if constexpr (LOG_COMPILED_LEVEL >= LOG_REQUEST) {
+        if (asyncLog != nullptr) {
+            for (int i = 0; i < (int)tickEvents.size(); i++) {
+                asyncLog->push(tickEvents[i]);
             }
-            servers[i]->processRequest(&next);
+        } else if (!tickEvents.empty()) {
+            logScratch.clear();
+            for (int i = 0; i < (int)tickEvents.size(); i++) {
+                renderRecord(tickEvents[i], logScratch);
+            }
+            logFile << logScratch;
         }
     }
+}
 
-    for (int i = 0; i < (int)servers.size(); i++) {
-        if (servers[i]->processTick()) {
-            stats.completedRequests++;
+// dump the recorder in the configured format
+void LoadBalancer::writeTimeSeries() {
+    bool binary = config.timeseriesFormat == "binary";
+    std::ofstream out(config.timeseriesFile, binary ? std::ios::out | std::ios::binary : std::ios::out);
+    if (!out.is_open()) {
+        if (console->admit(LOG_ERROR, "ERROR", RED)) {
+            beginLog("ERROR") << "Cannot write time series to " << config.timeseriesFile;
+            console->write(RED, logMessage.view());
         }
+        return;
+    }
+    if (binary) {
+        timeSeries->writeBinary(out);
+    } else {
+        timeSeries->writeCsv(out);
     }
 }
 
-// writes a tagged message to both terminal (with color) and log file
-void LoadBalancer::writeLog(const std::string& level, const std::string& colorCode, const std::string& message) {
-    std::string formatted = "[" + level + "] " + message;
-    std::cout << colorCode << formatted << RESET << '\n';
-    if (logFile.is_open()) {
-        logFile << formatted << '\n';
+// counters straight from stats; queue and pool gauges and latency percentiles summed over shards
+void LoadBalancer::publishMetrics() {
+    MetricsSnapshot& snapshot = metrics->writeSlot();
+    snapshot.cycle = currentTime;
+    snapshot.totalCycles = config.simulationCycles;
+    snapshot.generated = stats.generatedRequests;
+    snapshot.accepted = stats.acceptedRequests;
+    snapshot.blocked = stats.blockedRequests;
+    snapshot.completed = stats.completedRequests;
+    snapshot.shed = stats.shedFull + stats.shedOldest + stats.shedEarly;
+    snapshot.timedOut = 0;
+    snapshot.busyServers = 0;
+    for (int i = 0; i < (int)shards.size(); i++) {
+        snapshot.shed += shards[i]->codelDropCount();
+        snapshot.timedOut += shards[i]->timedOutCount();
+        snapshot.busyServers += shards[i]->busyThisTick();
     }
+    // one shard needs no merge
+    const Histogram* waits = &shards[0]->waitHistogram();
+    const Histogram* responses = &shards[0]->responseHistogram();
+    if (shards.size() > 1) {
+        metricsWaits.clear();
+        metricsResponses.clear();
+        for (int i = 0; i < (int)shards.size(); i++) {
+            metricsWaits.merge(shards[i]->waitHistogram());
+            metricsResponses.merge(shards[i]->responseHistogram());
+        }
+        waits = &metricsWaits;
+        responses = &metricsResponses;
+    }
+    snapshot.queued = queueSize();
+    snapshot.servers = serverCount;
+    snapshot.pendingServers = pendingServers();
+    snapshot.drainingServers = drainingServers;
+    snapshot.scaleUps = stats.scaleUpEvents;
+    snapshot.scaleDowns = stats.scaleDownEvents;
+    snapshot.waitMean = waits->mean();
+    snapshot.waitP99 = waits->percentile(99);
+    snapshot.responseP99 = responses->percentile(99);
+    snapshot.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loopStart).count();
+    metrics->publish();
+}
+
+// either sink is enough to make formatting worthwhile
+bool LoadBalancer::logs(LogLevel level) const {
+    return (level <= logLevel && logFile.is_open()) || console->wants(level);
 }
 
-// shortcut to write an INFO-level log line
-void LoadBalancer::logInfo(const std::string& message) {
-    writeLog("INFO", CYAN, message);
+// clears the shared message buffer and writes the tag
+LogBuffer& LoadBalancer::beginLog(const char* tag) {
+    logTag = tag;
+    logMessage.clear();
+    return logMessage << '[' << tag << "] ";
+}
+
+// writes the built message to the terminal (with color, if admitted) and the log file
+void LoadBalancer::writeLog(LogLevel level, const char* colorCode) {
+    if (console->admit(level, logTag, colorCode)) {
+        console->write(colorCode, logMessage.view());
+    }
+    if (level <= logLevel) {
+        logLine(logMessage.view());
+    }
+}
+
+// per-request record: queued for the writer thread, or formatted now
+void LoadBalancer::logEvent(const LogRecord& record) {
+    if (asyncLog != nullptr) {
+        asyncLog->push(record);
+    } else if (logFile.is_open()) {
+        logScratch.clear();
+        renderRecord(record, logScratch);
+        logFile << logScratch;
+    }
+}
+
+// a pool change as a structured record (only the binary log shows it)
+void LoadBalancer::logScale(int delta) {
+    if (logLevel >= LOG_SCALE && logFile.is_open()) {
+        LogRecord record;
+        record.kind = LOG_SCALED;
+        record.cycle = currentTime;
+        record.requestId = serverCount;
+        record.value = delta;
+        logEvent(record);
+    }
+}
+
+// binary or text, per log_format
+void LoadBalancer::renderRecord(const LogRecord& record, std::string& out) {
+    if (eventEncoder != nullptr) {
+        eventEncoder->encode(record, out);
+    } else {
+        AsyncLogger::format(record, out);
+    }
+}
+
+// text line, kept in order with the records
+void LoadBalancer::logLine(std::string_view line) {
+    if (asyncLog != nullptr) {
+        asyncLog->pushLine(line);
+    } else if (eventEncoder != nullptr) {
+        logScratch.clear();
+        size_t offset = 0;
+        do {
+            LogRecord record;
+            offset = AsyncLogger::textChunk(line, offset, record);
+            eventEncoder->encode(record, logScratch);
+        } while (offset < line.size());
+        logFile << logScratch;
+    } else if (logFile.is_open()) {
+        logFile << line << '\n';
+    }
+}
+
+// the per-cycle loop: arrivals, dispatch/tick, peak tracking, scaling, status
+void LoadBalancer::runCycles(RequestPipeline* pipeline) {
+    std::vector<PipelineItem> pipelineItems;
+    for (int cycle = 1; cycle <= config.simulationCycles; cycle++) {
+        currentTime = cycle;
+        console->advance(cycle);
+        int blockedBefore = stats.blockedRequests;
+        cycleArrivals = 0;
+        cycleArrivalWork = 0;
+        if (pipeline != nullptr) {
+            pipeline->receiveCycle(cycle, pipelineItems);
+            for (int i = 0; i < (int)pipelineItems.size(); i++) {
+                admitRequest(pipelineItems[i].request, pipelineItems[i].blocked);
+            }
+        } else {
+            randomAddNewRequests();
+        }
+        processTick();
+        retireDrained();
+
+        int queued = queueSize();
+        if (queued > stats.peakQueueSize) {
+            stats.peakQueueSize = queued;
+        }
+
+        stats.serverCycles += serverCount + drainingServers;
+        for (int i = 0; i < (int)shards.size(); i++) {
+            stats.provisioningCycles += shards[i]->provisioningCount();
+            stats.warmupCycles += shards[i]->warmingUpCount();
+        }
+        balanceLoad();
+
+        if (timeSeries != nullptr) {
+            int sample[TS_COLUMN_COUNT];
+            sample[TS_QUEUE] = queued;
+            sample[TS_BUSY] = 0;
+            for (int i = 0; i < (int)shards.size(); i++) {
+                sample[TS_BUSY] += shards[i]->busyThisTick();
+            }
+            sample[TS_SERVERS] = serverCount;
+            sample[TS_ARRIVALS] = cycleArrivals;
+            sample[TS_COMPLETIONS] = cycleCompleted;
+            sample[TS_BLOCKED] = stats.blockedRequests - blockedBefore;
+            timeSeries->record(sample);
+        }
+
+        if (metrics != nullptr && (cycle % config.metricsInterval == 0 || cycle == config.simulationCycles)) {
+            publishMetrics();
+        }
+
+        if (config.statusPrintInterval > 0 && cycle % config.statusPrintInterval == 0 && logs(LOG_INFO)) {
+            int queueCapacity = (int)(serviceCapacity() * MAX_QUEUE_PER_SERVER);
+            int qsize = queueSize();
+            int pct = queueCapacity > 0 ? qsize * 100 / queueCapacity : 0;
+            LogBuffer& msg = beginLog("INFO") << "Cycle " << cycle << '/' << config.simulationCycles << "  |  queue " << qsize << '/' << queueCapacity << " (" << pct << "%)  |  servers=" << serverCount << "  |  gen=" << stats.generatedRequests << " blocked=" << stats.blockedRequests << " done=" << stats.completedRequests;
+            if (config.serverBootCycles > 0) {
+                msg << " pending=" << pendingServers();
+            }
+            size_t beforeStatus = msg.size();
+            msg << "  |  ";
+            scaler->status(msg);
+            if (msg.size() == beforeStatus + 5) {
+                msg.truncate(beforeStatus);
+            }
+            writeLog(LOG_INFO, CYAN);
+        }
+    }
 }
 
 // runs the full simulation loop and returns stats at the end
 SimulationStats LoadBalancer::run() {
     initializeServers();
 
-    std::string bannerMsg = "Starting simulation for " + std::to_string(config.simulationCycles) + " cycles with " + std::to_string(servers.size()) + " server(s)";
-    logInfo(bannerMsg);
+    bool info = logs(LOG_INFO);
+    if (info) {
+        LogBuffer& msg = beginLog("INFO") << "Starting simulation for " << config.simulationCycles << " cycles with " << serverCount << " server(s)";
+        if (shards.size() > 1) {
+            msg << " on " << (int)shards.size() << " worker threads";
+        }
+        writeLog(LOG_INFO, CYAN);
+    }
 
-    if (!config.blockedRanges.empty()) {
-        std::string rangeMsg = "Blocked IP ranges (" + std::to_string(config.blockedRanges.size()) + "): ";
+    if (info && !config.blockedRanges.empty()) {
+        LogBuffer& msg = beginLog("INFO") << "Blocked IP ranges (" << (int)config.blockedRanges.size() << "): ";
         for (int i = 0; i < (int)config.blockedRanges.size(); i++) {
             if (i > 0) {
-                rangeMsg += ", ";
+                msg << ", ";
             }
-            rangeMsg += config.blockedRanges[i];
+            msg << config.blockedRanges[i];
         }
-        logInfo(rangeMsg);
+        writeLog(LOG_INFO, CYAN);
     }
 
     fillInitialQueue();
 
-    std::string qinfoMsg = "Initial queue: " + std::to_string(requestQueue.size()) + " requests | generated=" + std::to_string(stats.generatedRequests) + " | blocked=" + std::to_string(stats.blockedRequests) + " | accepted=" + std::to_string(stats.acceptedRequests);
-    logInfo(qinfoMsg);
+    if (info) {
+        beginLog("INFO") << "Initial queue: " << queueSize() << " requests | generated=" << stats.generatedRequests << " | blocked=" << stats.blockedRequests << " | accepted=" << stats.acceptedRequests;
+        writeLog(LOG_INFO, CYAN);
+    }
 
-    int cap = (int)servers.size() * MAX_QUEUE_PER_SERVER;
-    int fillPct = cap > 0 ? (int)(requestQueue.size() * 100 / cap) : 0;
-    std::string capinfoMsg = "Queue capacity: " + std::to_string(cap) + " (" + std::to_string(MAX_QUEUE_PER_SERVER) + " per server) | fill=" + std::to_string(fillPct) + "%  [scale-up >" + std::to_string(MAX_QUEUE_PER_SERVER) + "/srv, scale-down <" + std::to_string(MIN_QUEUE_PER_SERVER) + "/srv]";
-    logInfo(capinfoMsg);
+    if (info && config.serverSlots > 1) {
+        beginLog("INFO") << "Server slots: " << config.serverSlots << " (" << config.serverMode << ")";
+        writeLog(LOG_INFO, CYAN);
+    }
+    if (info && !config.serverTypes.empty()) {
+        LogBuffer& msg = beginLog("INFO") << "Server types:";
+        for (int t = 0; t < (int)types.size(); t++) {
+            msg << ' ' << types[t].name << "(speed ";
+            msg.fixed(types[t].speed, 2) << ", " << types[t].count << ')';
+        }
+        msg << " | scale-up type: " << config.scaleUpType;
+        writeLog(LOG_INFO, CYAN);
+    }
 
-    for (int cycle = 1; cycle <= config.simulationCycles; cycle++) {
-        currentTime = cycle;
-        randomAddNewRequests();
-        processTick();
+    if (info) {
+        int cap = (int)(serviceCapacity() * MAX_QUEUE_PER_SERVER);
+        int fillPct = cap > 0 ? queueSize() * 100 / cap : 0;
+        beginLog("INFO") << "Queue capacity: " << cap << " (" << MAX_QUEUE_PER_SERVER << " per server) | fill=" << fillPct << "%  [scale-up >" << MAX_QUEUE_PER_SERVER << "/srv, scale-down <" << MIN_QUEUE_PER_SERVER << "/srv]";
+        writeLog(LOG_INFO, CYAN);
+    }
 
-        if ((int)requestQueue.size() > stats.peakQueueSize) {
-            stats.peakQueueSize = (int)requestQueue.size();
+    RequestPipeline* pipeline = nullptr;
+    if (config.pipelineMode) {
+        pipeline = new RequestPipeline(config.pipelineRingSize);
+        pipeline->start(config.simulationCycles,
+                        [this](std::vector<Request>& out) { generateArrivals(out); },
+                        [this](const std::string& ip) { return ipBlocker->isBlocked(ip); });
+        if (info) {
+            beginLog("INFO") << "Pipelined mode: generate -> filter -> dispatch, ring size " << config.pipelineRingSize;
+            writeLog(LOG_INFO, CYAN);
         }
+    }
 
-        balanceLoad();
+    if (!config.timeseriesFile.empty()) {
+        timeSeries = new TimeSeries(config.simulationCycles, config.timeseriesWindow, config.timeseriesMaxRows);
+    }
 
-        if (config.statusPrintInterval > 0 && cycle % config.statusPrintInterval == 0) {
-            int capacity = (int)servers.size() * MAX_QUEUE_PER_SERVER;
-            int qsize = (int)requestQueue.size();
-            int pct = capacity > 0 ? qsize * 100 / capacity : 0;
-            std::string statusMsg = "Cycle " + std::to_string(cycle) + "/" + std::to_string(config.simulationCycles) + "  |  queue " + std::to_string(qsize) + "/" + std::to_string(capacity) + " (" + std::to_string(pct) + "%)  |  servers=" + std::to_string(servers.size()) + "  |  gen=" + std::to_string(stats.generatedRequests) + " blocked=" + std::to_string(stats.blockedRequests) + " done=" + std::to_string(stats.completedRequests);
-            logInfo(statusMsg);
+    if (config.metricsPort > 0) {
+        metrics = new MetricsServer();
+        std::string error;
+        if (metrics->start(config.metricsPort, error)) {
+            if (info) {
+                beginLog("INFO") << "Metrics endpoint: http://127.0.0.1:" << config.metricsPort << "/metrics and /status";
+                writeLog(LOG_INFO, CYAN);
+            }
+        } else {
+            // the run goes on without it
+            beginLog("ERROR") << "Cannot listen on 127.0.0.1:" << config.metricsPort << " for metrics: " << error;
+            writeLog(LOG_ERROR, RED);
+            delete metrics;
+            metrics = nullptr;
         }
     }
 
-    stats.finalQueueSize = (int)requestQueue.size();
-    stats.finalServerCount = (int)servers.size();
+    loopStart = std::chrono::steady_clock::now();
+    if (metrics != nullptr) {
+        publishMetrics();
+    }
+    runCycles(pipeline);
+    // the writer's backlog and the console's are part of the run's cost
+    console->finish(currentTime);
+    if (asyncLog != nullptr) {
+        asyncLog->stop();
+    }
+    stats.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loopStart).count();
 
+    if (pipeline != nullptr) {
+        pipeline->stop(stats.wallSeconds);
+        stats.pipelined = true;
+        for (int i = 0; i < RequestPipeline::STAGE_COUNT; i++) {
+            stats.pipelineStages[i] = pipeline->stageStats()[i];
+        }
+        delete pipeline;
+    }
+    if (asyncLog != nullptr) {
+        stats.asyncLog = true;
+        stats.logRecords = asyncLog->records();
+        stats.logDropped = asyncLog->dropped();
+        stats.logStalls = asyncLog->stalls();
+        stats.logWrites = asyncLog->batches();
+        // the summary is written directly from here on
+        delete asyncLog;
+        asyncLog = nullptr;
+    }
     if (logFile.is_open()) {
-        logFile << '\n';
-        logFile << "[INFO] ==== Simulation Summary ====\n";
-        logFile << "[INFO] Generated requests : " << stats.generatedRequests << '\n';
-        logFile << "[INFO] Accepted requests  : " << stats.acceptedRequests << '\n';
-        logFile << "[INFO] Blocked requests   : " << stats.blockedRequests << '\n';
-        logFile << "[INFO] Completed requests : " << stats.completedRequests << '\n';
-        logFile << "[INFO] Peak queue size    : " << stats.peakQueueSize << '\n';
-        logFile << "[INFO] Final queue size   : " << stats.finalQueueSize << '\n';
-        logFile << "[INFO] Servers added      : " << stats.addedServers << '\n';
-        logFile << "[INFO] Servers removed    : " << stats.removedServers << '\n';
-        logFile << "[INFO] Final server count : " << stats.finalServerCount << '\n';
-        logFile << "[INFO] Log file           : " << config.logFilePath << '\n';
+        stats.logBytes = (long long)logFile.tellp();
+    }
+    if (timeSeries != nullptr) {
+        timeSeries->finish();
+        writeTimeSeries();
+        stats.timeseriesRows = timeSeries->rows();
+        stats.timeseriesWindow = timeSeries->window();
+    }
+    if (metrics != nullptr) {
+        // the last snapshot stays up until the summary is written
+        metrics->stop();
+        stats.metricsEndpoint = true;
+        stats.metricsSnapshots = metrics->published();
+        stats.metricsScrapes = metrics->scrapes();
+    }
+    stats.consoleLines = console->lines();
+    stats.consoleSuppressed = console->suppressed();
+    stats.finalQueueSize = queueSize();
+    stats.finalServerCount = serverCount;
+    stats.finalPendingServers = pendingServers();
+    stats.finalDrainingServers = drainingServers;
+    for (int i = 0; i < (int)shards.size(); i++) {
+        stats.waitTimes.merge(shards[i]->waitHistogram());
+        stats.responseTimes.merge(shards[i]->responseHistogram());
+        stats.serviceTimes.merge(shards[i]->serviceHistogram());
+        stats.preemptions += shards[i]->preemptionCount();
+        stats.timedOutRequests += shards[i]->timedOutCount();
+        stats.lateCompletions += shards[i]->lateCount();
+        stats.shedCoDel += shards[i]->codelDropCount();
+        stats.drainTimes.merge(shards[i]->drainHistogram());
+        stats.affinity.merge(shards[i]->affinityStats());
+        for (int lane = 0; lane < FairQueue::LANE_COUNT; lane++) {
+            stats.jobTypeWaits[lane].merge(shards[i]->waitHistogram(lane));
+            stats.jobTypeResponses[lane].merge(shards[i]->responseHistogram(lane));
+        }
+        const std::vector<WebServer*>& live = shards[i]->serverList();
+        for (int j = 0; j < (int)live.size(); j++) {
+            stats.serverTypes[live[j]->typeIndex()].finalServers++;
+            recordServerType(live[j]);
+        }
+    }
+    if (config.simulationCycles > 0) {
+        stats.goodput = (double)(stats.completedRequests - stats.lateCompletions) / config.simulationCycles;
+    }
+
+    if (logFile.is_open() && logLevel >= LOG_INFO) {
+        // built whole, then written line by line so the binary log gets it as text records
+        std::stringstream summary;
+        summary << '\n';
+        summary << "[INFO] ==== Simulation Summary ====\n";
+        summary << "[INFO] Generated requests : " << stats.generatedRequests << '\n';
+        summary << "[INFO] Accepted requests  : " << stats.acceptedRequests << '\n';
+        summary << "[INFO] Blocked requests   : " << stats.blockedRequests << '\n';
+        summary << "[INFO] Completed requests : " << stats.completedRequests << '\n';
+        summary << "[INFO] Peak queue size    : " << stats.peakQueueSize << '\n';
+        summary << "[INFO] Final queue size   : " << stats.finalQueueSize << '\n';
+        summary << "[INFO] Servers added      : " << stats.addedServers << '\n';
+        summary << "[INFO] Servers removed    : " << stats.removedServers << '\n';
+        summary << "[INFO] Scale events       : up=" << stats.scaleUpEvents << " down=" << stats.scaleDownEvents << '\n';
+        summary << "[INFO] Final server count : " << stats.finalServerCount << '\n';
+        summary << "[INFO] Scaling policy     : " << stats.scalingPolicy << '\n';
+        summary << "[INFO] Scale-down blocked : " << stats.scaleDownBlocked << " events, " << stats.scaleDownShortfall << " servers short of idle\n";
+        if (config.scaleDownDrain) {
+            summary << "[INFO] Drained servers    : " << stats.drainedServers << " (drain cycles mean=" << stats.drainTimes.mean() << " p99=" << stats.drainTimes.percentile(99) << " max=" << stats.drainTimes.max() << ", still draining=" << stats.finalDrainingServers << ")\n";
+        }
+        summary << "[INFO] Server cycles      : " << stats.serverCycles << '\n';
+        if (config.serverBootCycles > 0 || config.serverWarmupCycles > 0) {
+            summary << "[INFO] Cold start         : provisioning=" << stats.provisioningCycles << " warm-up=" << stats.warmupCycles << " server-cycles, pending at end=" << stats.finalPendingServers << '\n';
+        }
+        summary << "[INFO] Dispatch policy    : " << stats.dispatchPolicy << '\n';
+        if (stats.affinity.lookups > 0) {
+            const AffinityStats& affinity = stats.affinity;
+            summary << "[INFO] Affinity           : fallbacks=" << affinity.fallbacks << "/" << affinity.lookups << " (" << 100.0 * affinity.fallbacks / affinity.lookups << "%) rebuilds=" << affinity.rebuilds << " (" << affinity.rebuildSeconds * 1000 << " ms) remapped mean=" << (affinity.rebuilds > 0 ? 100.0 * affinity.remappedSum / affinity.rebuilds : 0.0) << "% max=" << 100.0 * affinity.maxRemapped << "%\n";
+        }
+        if (stats.cacheLookups > 0) {
+            summary << "[INFO] Cache hit rate     : " << 100.0 * stats.cacheHits / stats.cacheLookups << "% (" << stats.cacheHits << "/" << stats.cacheLookups << ", " << stats.cachePolicy << " x" << config.cacheCapacity << " per server, dispatch " << stats.dispatchPolicy << ")\n";
+        }
+        for (int t = 0; !config.serverTypes.empty() && t < (int)stats.serverTypes.size(); t++) {
+            const ServerTypeStats& typeStats = stats.serverTypes[t];
+            summary << "[INFO] Type " << typeStats.name << " (speed " << typeStats.speed << "): final=" << typeStats.finalServers << " added=" << typeStats.addedServers << " removed=" << typeStats.removedServers << " completed=" << typeStats.completed << " utilization=" << (int)(typeStats.utilization() * 100) << "%\n";
+        }
+        const ServerLoadStats& load = stats.serverLoad;
+        summary << "[INFO] Server utilization : mean=" << (int)(load.meanUtilization() * 100) << "% min=" << (int)(load.minUtilization * 100) << "% p50=" << load.utilization.percentile(50) / 10 << "% p90=" << load.utilization.percentile(90) / 10 << "% max=" << (int)(load.maxUtilization * 100) << "% (" << load.servers << " servers, hottest " << load.hottest << ")\n";
+        summary << "[INFO] Load imbalance     : jain=" << load.jainIndex() << " utilization max/mean=" << load.utilizationImbalance() << " completions max/mean=" << load.completionImbalance() << '\n';
+        summary << "[INFO] Queue discipline   : " << stats.queueDiscipline << '\n';
+        const char* latencyNames[] = {"Queue wait (cycles): ", "Service (cycles)   : ", "Response (cycles)  : "};
+        const Histogram* latencies[] = {&stats.waitTimes, &stats.serviceTimes, &stats.responseTimes};
+        for (int k = 0; k < 3; k++) {
+            const Histogram& h = *latencies[k];
+            summary << "[INFO] " << latencyNames[k] << "mean=" << h.mean() << " p50=" << h.percentile(50) << " p90=" << h.percentile(90) << " p99=" << h.percentile(99) << " p99.9=" << h.percentile(99.9) << " max=" << h.max() << '\n';
+        }
+        for (int lane = 0; lane < FairQueue::LANE_COUNT; lane++) {
+            const Histogram& wait = stats.jobTypeWaits[lane];
+            const Histogram& response = stats.jobTypeResponses[lane];
+            summary << "[INFO] Job type " << (lane == 0 ? 'P' : 'S');
+            if (stats.fairQueueing) {
+                summary << " (weight " << config.jobTypeWeights[lane] << ")";
+            }
+            summary << " : wait mean=" << wait.mean() << " p99=" << wait.percentile(99) << " | response mean=" << response.mean() << " p99=" << response.percentile(99) << " | completed=" << response.count() << '\n';
+        }
+        if (stats.queueDiscipline == "srpt") {
+            summary << "[INFO] Preemptions        : " << stats.preemptions << '\n';
+        }
+        // CoDel drops at dequeue even with an unbounded queue
+        if (config.queueCapacity > 0 || stats.shedPolicy == "codel" || stats.shedRequests() > 0) {
+            summary << "[INFO] Shed requests      : " << stats.shedRequests() << " (" << stats.shedPolicy << ": full=" << stats.shedFull << " oldest=" << stats.shedOldest << " early=" << stats.shedEarly << " codel=" << stats.shedCoDel << ")\n";
+        }
+        if (config.requestTimeout > 0) {
+            summary << "[INFO] Timed out requests : " << stats.timedOutRequests << '\n';
+            summary << "[INFO] Late completions   : " << stats.lateCompletions << '\n';
+            summary << "[INFO] Goodput            : " << stats.goodput << " requests/cycle\n";
+        }
+        if (stats.workerThreads > 1) {
+            summary << "[INFO] Worker threads     : " << stats.workerThreads << '\n';
+            summary << "[INFO] Stolen requests    : " << stats.stolenRequests << '\n';
+        }
+        if (stats.pipelined) {
+            for (int i = 0; i < RequestPipeline::STAGE_COUNT; i++) {
+                const StageStats& stage = stats.pipelineStages[i];
+                summary << "[INFO] Stage " << RequestPipeline::stageName(i) << " : items=" << stage.items << " busy=" << stage.busySeconds << "s wait-in=" << stage.inputWaitSeconds << "s wait-out=" << stage.outputWaitSeconds << "s util=" << (int)(stage.utilization() * 100) << "%\n";
+            }
+        }
+        summary << "[INFO] Log volume         : " << stats.logBytes << " bytes (" << (stats.generatedRequests > 0 ? (double)stats.logBytes / stats.generatedRequests : 0.0) << " bytes/request, " << config.logFormat << ")\n";
+        if (stats.asyncLog) {
+            summary << "[INFO] Async log          : records=" << stats.logRecords << " dropped=" << stats.logDropped << " stalls=" << stats.logStalls << " writes=" << stats.logWrites << " (" << config.logOverflow << ", ring " << config.logRingSize << ")\n";
+        }
+        if (stats.timeseriesRows > 0) {
+            summary << "[INFO] Time series        : " << stats.timeseriesRows << " rows x " << stats.timeseriesWindow << " cycles -> " << config.timeseriesFile << " (" << config.timeseriesFormat << ")\n";
+        }
+        if (stats.metricsEndpoint) {
+            summary << "[INFO] Metrics endpoint   : http://127.0.0.1:" << config.metricsPort << " (" << stats.metricsSnapshots << " snapshots, " << stats.metricsScrapes << " scrapes)\n";
+        }
+        summary << "[INFO] Console            : " << stats.consoleLines << " lines, " << stats.consoleSuppressed << " suppressed (" << config.consoleLevel << ", " << config.consoleBurst << " per tag per " << config.consoleWindow << " cycles)\n";
+        summary << "[INFO] Log file           : " << config.logFilePath << '\n';
+        std::string line;
+        while (std::getline(summary, line)) {
+            logLine(line);
+        }
     }
 
     return stats;
@@ -3,9 +3,10 @@
  * @brief Defines the LoadBalancer class and SimulationStats struct used to
  *        drive and report on the entire load balancer simulation.
  *
- * The LoadBalancer owns a pool of WebServer objects, a FIFO request queue,
- * an IP firewall (IPBlocker), and an output log file. Each call to run()
- * executes the full simulation and returns a SimulationStats summary.
+ * The LoadBalancer owns a pool of WebServer objects split across one or
+ * more Shard partitions, an IP firewall (IPBlocker), and an output log file.
+ * Each call to run() executes the full simulation and returns a
+ * SimulationStats summary.
  *
  * @author Karan Bhagat
  * @date 2026
@@ -14,15 +15,141 @@
 #ifndef LOADBALANCER_H
 #define LOADBALANCER_H
 
+#include <chrono>
 #include <fstream>
-#include <queue>
 #include <string>
 #include <vector>
 
+#include "AsyncLogger.h"
 #include "Config.h"
+#include "ConsoleSink.h"
+#include "EventLog.h"
+#include "FairQueue.h"
+#include "Histogram.h"
 #include "IPBlocker.h"
+#include "LoadShedding.h"
+#include "LogBuffer.h"
+#include "MetricsServer.h"
+#include "Pipeline.h"
 #include "Request.h"
+#include "ScalingPolicy.h"
+#include "Shard.h"
+#include "TimeSeries.h"
 #include "WebServer.h"
+#include "WorkerPool.h"
+
+/**
+ * @struct ServerTypeStats
+ * @brief Per-type totals for a heterogeneous server pool.
+ *
+ * Servers fold their counters in when they are removed and at the end of
+ * the run, so the totals cover every server that ever existed.
+ */
+struct ServerTypeStats {
+    std::string name;        ///< Type name (ServerType::name).
+    double speed;            ///< Type speed factor.
+    int addedServers;        ///< Servers of this type added by scale-up.
+    int removedServers;      ///< Servers of this type removed by scale-down.
+    int finalServers;        ///< Servers of this type alive at the end.
+    long long completed;     ///< Requests completed by servers of this type.
+    double busyTime;         ///< Sum of WebServer::busyTime() over all servers of this type.
+    long long lifetimeTicks; ///< Sum of WebServer::lifetimeTicks() over all servers of this type.
+
+    ServerTypeStats() {
+        speed = 1.0;
+        addedServers = 0;
+        removedServers = 0;
+        finalServers = 0;
+        completed = 0;
+        busyTime = 0.0;
+        lifetimeTicks = 0;
+    }
+
+    /** @brief Busy time over lifetime, in [0, 1]. */
+    double utilization() const {
+        return lifetimeTicks > 0 ? busyTime / lifetimeTicks : 0.0;
+    }
+};
+
+/**
+ * @struct ServerLoadStats
+ * @brief How evenly load was spread over individual servers.
+ *
+ * Each server is added once, when it leaves the pool or at the end of the
+ * run, from the busy time, lifetime and completions it already keeps, so
+ * nothing is scanned per cycle. Servers that never ran a cycle are skipped.
+ */
+struct ServerLoadStats {
+    int servers;                ///< Servers added.
+    double utilizationSum;      ///< Sum of per-server utilization.
+    double utilizationSquares;  ///< Sum of squared per-server utilization, for Jain's index.
+    double maxUtilization;      ///< Busiest server's utilization.
+    double minUtilization;      ///< Idlest server's utilization.
+    double rateSum;             ///< Sum of per-server completions per 1000 cycles alive.
+    double maxRate;             ///< Highest per-server completion rate.
+    std::string hottest;        ///< Id of the busiest server.
+    Histogram utilization;      ///< Per-server utilization in tenths of a percent (0-1000).
+
+    ServerLoadStats() {
+        servers = 0;
+        utilizationSum = 0.0;
+        utilizationSquares = 0.0;
+        maxUtilization = 0.0;
+        minUtilization = 0.0;
+        rateSum = 0.0;
+        maxRate = 0.0;
+    }
+
+    /**
+     * @brief Adds one server.
+     * @param id        WebServer::id().
+     * @param busy      WebServer::busyTime().
+     * @param lifetime  WebServer::lifetimeTicks().
+     * @param completed WebServer::completedCount().
+     */
+    void add(const std::string& id, double busy, long long lifetime, long long completed) {
+        if (lifetime <= 0) {
+            return;
+        }
+        double u = busy / lifetime;
+        double rate = 1000.0 * completed / lifetime;
+        if (servers == 0 || u > maxUtilization) {
+            maxUtilization = u;
+            hottest = id;
+        }
+        if (servers == 0 || u < minUtilization) {
+            minUtilization = u;
+        }
+        if (rate > maxRate) {
+            maxRate = rate;
+        }
+        servers++;
+        utilizationSum += u;
+        utilizationSquares += u * u;
+        rateSum += rate;
+        utilization.record((int)(u * 1000 + 0.5));
+    }
+
+    /** @brief Mean per-server utilization, in [0, 1]. */
+    double meanUtilization() const {
+        return servers > 0 ? utilizationSum / servers : 0.0;
+    }
+
+    /** @brief Jain's fairness index of utilization: 1 = perfectly even, 1/n = one server did everything. */
+    double jainIndex() const {
+        return utilizationSquares > 0.0 ? utilizationSum * utilizationSum / (servers * utilizationSquares) : 1.0;
+    }
+
+    /** @brief Busiest server's utilization over the mean (1 = even). */
+    double utilizationImbalance() const {
+        return utilizationSum > 0.0 ? maxUtilization * servers / utilizationSum : 1.0;
+    }
+
+    /** @brief Highest per-server completion rate over the mean (1 = even). */
+    double completionImbalance() const {
+        return rateSum > 0.0 ? maxRate * servers / rateSum : 1.0;
+    }
+};
 
 /**
  * @struct SimulationStats
@@ -37,11 +164,64 @@ struct SimulationStats {
     int acceptedRequests;   ///< Requests that passed the firewall and entered the queue.
     int blockedRequests;    ///< Requests rejected by the IPBlocker firewall.
     int completedRequests;  ///< Requests that finished processing on a server.
-    int addedServers;       ///< Number of scale-up events (servers added).
-    int removedServers;     ///< Number of scale-down events (servers removed).
+    int addedServers;       ///< Servers added by scale-up.
+    int removedServers;     ///< Servers removed by scale-down.
+    int scaleUpEvents;      ///< Scale-up events (one per batch, however many servers it added).
+    int scaleDownEvents;    ///< Scale-down events that removed at least one server.
     int peakQueueSize;      ///< Largest queue depth observed across all cycles.
     int finalQueueSize;     ///< Queue depth at the end of the last cycle.
     int finalServerCount;   ///< Number of active servers when the simulation ended.
+    int stolenRequests;     ///< Requests moved between shards by work stealing.
+    int workerThreads;      ///< Number of shards/threads the run used.
+    double wallSeconds;     ///< Wall-clock time spent in the main simulation loop.
+    std::string dispatchPolicy; ///< Name of the dispatch policy used.
+    std::vector<ServerTypeStats> serverTypes; ///< Per-type breakdown (one entry per server type).
+    ServerLoadStats serverLoad; ///< Per-server utilization spread and imbalance.
+    Histogram waitTimes;    ///< Cycles each dispatched request spent in the queue.
+    Histogram responseTimes; ///< Cycles from entering the queue to completion, per finished request.
+    Histogram serviceTimes; ///< Cycles from first dispatch to completion (including preempted time), per finished request.
+    std::string queueDiscipline; ///< Queue order used (see RequestQueue::parseDiscipline()).
+    long long preemptions;  ///< Running requests preempted under SRPT.
+    long long timedOutRequests; ///< Requests whose client gave up while they were still queued.
+    long long lateCompletions;  ///< Requests that finished after their client had given up.
+    double goodput;         ///< Requests completed within their timeout, per cycle.
+    long long shedFull;     ///< Arrivals rejected because the queue was at capacity.
+    long long shedOldest;   ///< Queued requests dropped to make room (drop_oldest).
+    long long shedEarly;    ///< Arrivals dropped early by RED.
+    long long shedCoDel;    ///< Queued requests dropped by CoDel at dequeue.
+    std::string shedPolicy; ///< Shedding policy used.
+    std::string scalingPolicy; ///< Autoscaler used.
+    long long serverCycles; ///< Sum over cycles of the pool size (the cost of the run).
+    long long provisioningCycles; ///< Server-cycles spent provisioning (paid for, no work accepted).
+    long long warmupCycles; ///< Server-cycles spent serving at reduced warm-up speed.
+    int finalPendingServers; ///< Servers still provisioning when the simulation ended.
+    int scaleDownBlocked;   ///< Scale-down events that found fewer idle servers than asked for.
+    int scaleDownShortfall; ///< Servers those events were short by.
+    int drainedServers;     ///< Draining servers retired once their last request finished.
+    int finalDrainingServers; ///< Servers still draining when the simulation ended.
+    Histogram drainTimes;   ///< Cycles from the start of draining to retirement, per retired server.
+    AffinityStats affinity; ///< Client-affinity counters, summed over shards (maglev and jump_hash only).
+    std::string cachePolicy; ///< Per-server response cache policy (see ResponseCache::parsePolicy()).
+    long long cacheHits;    ///< Requests whose response was in their server's cache.
+    long long cacheLookups; ///< Requests looked up in a server cache.
+    bool fairQueueing;      ///< @c true if P and S requests had their own DRR lanes.
+    Histogram jobTypeWaits[FairQueue::LANE_COUNT];     ///< waitTimes split by job type (FairQueue::laneFor()).
+    Histogram jobTypeResponses[FairQueue::LANE_COUNT]; ///< responseTimes split by job type.
+    bool pipelined;         ///< @c true if generation/filtering ran on their own threads.
+    StageStats pipelineStages[RequestPipeline::STAGE_COUNT]; ///< Per-stage timing (pipelined runs only).
+    bool asyncLog;          ///< @c true if the log file was written by an AsyncLogger.
+    long long logRecords;   ///< Records handed to the AsyncLogger.
+    long long logDropped;   ///< Records it dropped because its ring was full.
+    long long logStalls;    ///< Times the simulation waited for room in its ring.
+    long long logWrites;    ///< Buffered writes its writer thread made.
+    long long logBytes;     ///< Size of the log file when the loop ended (before the summary).
+    long long consoleLines;      ///< Lines the ConsoleSink wrote to the terminal.
+    long long consoleSuppressed; ///< Per-request lines it held back under its rate limit.
+    int timeseriesRows;     ///< Rows the TimeSeries recorder wrote (0 if off).
+    int timeseriesWindow;   ///< Cycles per time series row.
+    bool metricsEndpoint;   ///< @c true if the MetricsServer was listening.
+    long long metricsSnapshots; ///< Snapshots published to it.
+    long long metricsScrapes;   ///< HTTP responses it sent.
 
     SimulationStats() {
         generatedRequests = 0;
@@ -50,9 +230,52 @@ struct SimulationStats {
         completedRequests = 0;
         addedServers = 0;
         removedServers = 0;
+        scaleUpEvents = 0;
+        scaleDownEvents = 0;
         peakQueueSize = 0;
         finalQueueSize = 0;
         finalServerCount = 0;
+        stolenRequests = 0;
+        workerThreads = 1;
+        wallSeconds = 0.0;
+        preemptions = 0;
+        timedOutRequests = 0;
+        lateCompletions = 0;
+        goodput = 0.0;
+        shedFull = 0;
+        shedOldest = 0;
+        shedEarly = 0;
+        shedCoDel = 0;
+        serverCycles = 0;
+        provisioningCycles = 0;
+        warmupCycles = 0;
+        finalPendingServers = 0;
+        scaleDownBlocked = 0;
+        scaleDownShortfall = 0;
+        drainedServers = 0;
+        finalDrainingServers = 0;
+        cacheHits = 0;
+        cacheLookups = 0;
+        fairQueueing = false;
+        pipelined = false;
+        asyncLog = false;
+        logRecords = 0;
+        logDropped = 0;
+        logStalls = 0;
+        logWrites = 0;
+        logBytes = 0;
+        consoleLines = 0;
+        consoleSuppressed = 0;
+        timeseriesRows = 0;
+        timeseriesWindow = 0;
+        metricsEndpoint = false;
+        metricsSnapshots = 0;
+        metricsScrapes = 0;
+    }
+
+    /** @brief Requests shed by every mechanism (full, oldest, early, CoDel). */
+    long long shedRequests() const {
+        return shedFull + shedOldest + shedEarly + shedCoDel;
     }
 };
 
@@ -72,6 +295,17 @@ struct SimulationStats {
  *     (balanceLoad()).
  *
  * All notable events are written to the log file with color-coded tags.
+ *
+ * With Config::workerThreads greater than one, servers and queued requests
+ * are partitioned into that many shards. Arrivals are routed to shards
+ * round-robin, idle shards steal queued requests from backed-up ones at the
+ * start of each cycle, and the shards are then ticked in parallel. Stealing
+ * and log output happen on the main thread in shard order, so a run is
+ * deterministic for a given seed and thread count.
+ *
+ * With Config::pipelineMode set, step 1 is split off into a RequestPipeline:
+ * generation and firewall filtering run on their own threads and the main
+ * loop only admits the already-filtered arrivals for each cycle.
  */
 class LoadBalancer {
 public:
@@ -100,33 +334,86 @@ public:
     void addRequest(const Request& request);
 
     /**
-     * @brief Allocates a new WebServer and appends it to the server pool.
+     * @brief Counts, logs and enqueues a request whose firewall verdict is
+     *        already known.
+     *
+     * Shared by addRequest() and the pipelined loop, where the filter stage
+     * has run the IPBlocker check on another thread.
+     *
+     * @param request The Request to enqueue.
+     * @param blocked Result of the IPBlocker check for @p request.
+     */
+    void admitRequest(const Request& request, bool blocked);
+
+    /**
+     * @brief Allocates a new WebServer of the default scale-up type and
+     *        gives it to the shard with the fewest servers.
+     *
+     * Like every scaled-up server it first provisions for
+     * Config::serverBootCycles and then warms up.
      */
     void addServer();
 
     /**
      * @brief Removes an idle server from the pool to free capacity.
-     * @return @c true if an idle server was found and removed;
-     *         @c false if all servers are currently busy.
+     * @return @c true if an idle server was removed, or a busy one started
+     *         draining (Config::scaleDownDrain); @c false otherwise.
      */
     bool removeServer();
 
     /**
-     * @brief Evaluates queue depth and adjusts the server pool size.
+     * @brief Adds a batch of servers as one scale-up event.
+     *
+     * Each server's type is chosen by chooseServerType() from the capacity
+     * still wanted, and each goes to the shard with the fewest servers.
+     * Counted in SimulationStats::addedServers and the per-type totals.
+     *
+     * @param count          Servers to add.
+     * @param neededCapacity Capacity the scaling policy asked for.
+     * @return Type index of the last server added.
+     */
+    int addServers(int count, double neededCapacity);
+
+    /**
+     * @brief Removes up to @p count idle servers as one scale-down event.
+     *
+     * The shard with the most servers is tried first, then the others;
+     * each shard is scanned and compacted once, so the cost is O(pool)
+     * for the whole batch rather than per server. If there are not enough
+     * idle servers the event counts as blocked, and with
+     * Config::scaleDownDrain the rest are made up by draining busy servers:
+     * they leave the pool's server count and capacity at once, take no new
+     * work, and are retired by retireDrained() when their last request
+     * finishes.
      *
-     * Uses per-server thresholds (hard-coded as local constants):
-     * - Scale up  when queue depth exceeds MAX_QUEUE_PER_SERVER × servers.
-     * - Scale down when queue depth falls below MIN_QUEUE_PER_SERVER × servers
-     *   AND the scaling cooldown timer has expired.
+     * @param count Servers to remove.
+     * @return Number removed or set draining.
+     */
+    int removeServers(int count);
+
+    /**
+     * @brief Asks the scaling policy for a pool change and carries it out.
+     *
+     * The policy sees this cycle's queue depth, pool size and capacity
+     * (where a server contributes WebServer::serviceRate(): slots × speed
+     * in FCFS mode and speed in processor-sharing mode) plus the cycle's
+     * arrivals and completions. On scale-up each server's type is chosen
+     * by chooseServerType() from the capacity still wanted; scale-down
+     * removes idle servers only. Whatever the policy, the change is
+     * clipped to [Config::minServers, Config::maxServers] and carried out
+     * as one batch with addServers() or removeServers(); one log line is
+     * written per batch.
      */
     void balanceLoad();
 
     /**
      * @brief Executes one simulation clock cycle.
      *
-     * Iterates over all servers: idle servers receive the next queued
-     * request (if any); busy servers are ticked and their completion
-     * counter is updated when they finish.
+     * Rebalances queued work between shards, then ticks every shard (in
+     * parallel when more than one worker thread is configured). Within a
+     * shard, idle servers receive the next queued request (if any); busy
+     * servers are ticked and their completion counter is updated when they
+     * finish.
      */
     void processTick();
 
@@ -145,20 +432,112 @@ private:
     Config config;                      ///< Copy of the simulation configuration.
     IPBlocker* ipBlocker;               ///< Pointer to the firewall/IP blocker.
     std::ofstream logFile;              ///< Output stream for the simulation log.
-    std::queue<Request> requestQueue;   ///< FIFO queue of pending requests.
-    std::vector<WebServer*> servers;    ///< Pool of dynamically allocated servers.
+    AsyncLogger* asyncLog;              ///< Background writer owning logFile during the run, or @c nullptr.
+    EventLogEncoder* eventEncoder;      ///< Binary encoder when Config::logFormat is binary, else @c nullptr.
+    std::vector<LogRecord> tickEvents;  ///< Reused buffer for the shards' log records each cycle.
+    std::string logScratch;             ///< Reused buffer for synchronous log formatting.
+    LogBuffer logMessage;               ///< Reused buffer the current text message is built in.
+    const char* logTag;                 ///< Tag of the message in logMessage.
+    LogLevel logLevel;                  ///< Most verbose level written to the log file.
+    ConsoleSink* console;               ///< Rate-limited, buffered terminal output.
+    TimeSeries* timeSeries;             ///< Per-cycle metrics recorder, or @c nullptr when off.
+    MetricsServer* metrics;             ///< Live HTTP metrics endpoint, or @c nullptr when off.
+    Histogram metricsWaits;             ///< Scratch for merging shard wait histograms into a snapshot.
+    Histogram metricsResponses;         ///< Scratch for merging shard response histograms into a snapshot.
+    std::chrono::steady_clock::time_point loopStart; ///< When the cycle loop started.
+    std::vector<Shard*> shards;         ///< Partitions of the server pool and queue.
+    WorkerPool* workers;                ///< Threads used to tick shards in parallel.
+    AdmissionControl* admission;        ///< Queue capacity and arrival-time shedding.
+    ScalingPolicy* scaler;              ///< Decides when to add or remove servers.
+    std::vector<Request> arrivals;      ///< Reused buffer for one cycle's arrivals.
 
     int currentTime;      ///< Current simulation cycle number (1-based).
     int nextRequestId;    ///< Auto-incrementing ID counter for new requests.
-    int cooldownTimer;    ///< Cycles remaining before the next scale-down is allowed.
+    int nextShard;        ///< Round-robin cursor for routing arrivals to shards.
+    bool routeByClient;   ///< Route arrivals to shards by client IP hash (affinity policies, several shards).
+    unsigned long long timeoutRng; ///< xorshift64 state for drawing request timeouts.
+    int serverCount;      ///< Servers across all shards, not counting draining ones.
+    int nextServerId;     ///< Numeric part of the next server id, so ids are never reused.
+    std::vector<std::string> clientIps; ///< Client population when Config::clientCount is set.
+    int drainingServers;  ///< Servers draining and not yet retired.
+    ServiceMode serverMode;   ///< Service mode given to every new server.
+    CachePolicy cachePolicy;  ///< Response cache given to every new server.
+    std::vector<ServerType> types; ///< Server types in use (one implicit type if none configured).
+    double capacity;          ///< Sum of WebServer::serviceRate() over the pool.
+    int cycleArrivals;    ///< Requests admitted to the queue so far this cycle.
+    long long cycleArrivalWork; ///< Sum of their timeRequired.
+    int cycleCompleted;   ///< Requests completed this cycle.
+    long long admittedWork; ///< Sum of timeRequired over every admitted request.
     SimulationStats stats;///< Accumulates counters as the simulation runs.
 
+    /** @brief Capacity units of the whole pool (sum of server service rates). */
+    double serviceCapacity() const;
+
+    /**
+     * @brief Allocates a server of the given type and gives it to the shard
+     *        with the fewest servers.
+     * @param type Index into @c types.
+     * @param cold Whether the server goes through Config::serverBootCycles
+     *             and Config::serverWarmupCycles first (scale-up) or is
+     *             ready at once (initial pool).
+     */
+    void addServerOfType(int type, bool cold);
+
+    /** @brief Servers still provisioning, across all shards. */
+    int pendingServers() const;
+
+    /**
+     * @brief Collects the servers the shards retired this cycle after
+     *        draining, folds their counters into the stats and frees them.
+     */
+    void retireDrained();
+
+    /**
+     * @brief Picks the server type to add on scale-up.
+     *
+     * Uses Config::scaleUpType if it names a type; otherwise the smallest
+     * type whose capacity covers @p neededCapacity, or the largest type if
+     * none does.
+     *
+     * @param neededCapacity Capacity units the backlog calls for.
+     * @return Index into @c types.
+     */
+    int chooseServerType(double neededCapacity) const;
+
+    /**
+     * @brief Adds a server's counters to its type's totals and to the per-server load spread.
+     * @param server Server being removed, or still alive at the end of the run.
+     */
+    void recordServerType(const WebServer* server);
+
+    /** @brief Total number of queued requests across all shards. */
+    int queueSize() const;
+
+    /**
+     * @brief Moves queued requests from shards with more work than free
+     *        slots to shards with free slots and nothing queued for them.
+     *
+     * Runs on the main thread before the parallel phase; shards are visited
+     * in index order so the result does not depend on thread timing.
+     */
+    void stealWork();
+
     /**
      * @brief Creates a new randomised Request using the current ID counter.
      * @return A fully populated Request ready for queuing.
      */
     Request generateRequest();
 
+    /**
+     * @brief Draws one client timeout from Config::requestTimeoutDist.
+     *
+     * Uses a private generator so turning timeouts on does not change the
+     * arrival sequence produced by rand().
+     *
+     * @return Timeout in cycles (at least 1).
+     */
+    int drawTimeout();
+
     /** @brief Creates Config::initialServers WebServer objects at simulation start. */
     void initializeServers();
 
@@ -170,27 +549,79 @@ private:
      */
     void fillInitialQueue();
 
+    /**
+     * @brief Randomly generates the arrivals for one cycle.
+     *
+     * Uses rand() to decide whether 0 or 1 new requests arrive. This is the
+     * only place the main loop draws random numbers, so it can run on the
+     * pipeline's generator thread without changing the request stream.
+     *
+     * @param out Vector the new requests are appended to.
+     */
+    void generateArrivals(std::vector<Request>& out);
+
     /**
      * @brief Randomly injects new requests during the main simulation loop.
      *
-     * Called once per cycle. Uses rand() to decide whether 0, 1, or 2 new
-     * requests should arrive this cycle.
+     * Called once per cycle in serial mode; generates this cycle's arrivals
+     * and passes each one through addRequest().
      */
     void randomAddNewRequests();
 
     /**
-     * @brief Core log-write helper used by all logging methods.
-     * @param level     Tag string (e.g. "INFO", "BLOCK", "SCALE UP").
+     * @brief Main cycle loop used by run().
+     * @param pipeline Pipeline supplying arrivals, or @c nullptr for serial mode.
+     */
+    void runCycles(RequestPipeline* pipeline);
+
+    /** @brief Writes the TimeSeries to Config::timeseriesFile (csv or binary). */
+    void writeTimeSeries();
+
+    /** @brief Fills the MetricsServer's snapshot from the current state and publishes it. */
+    void publishMetrics();
+
+    /** @brief @c true if the log file or the console takes messages at @p level. */
+    bool logs(LogLevel level) const;
+
+    /**
+     * @brief Starts a tagged text message in logMessage.
+     *
+     * Callers check logs() first, append the body to the returned buffer
+     * and finish with writeLog() (or logLine() for the file alone).
+     * @param tag Tag string literal (e.g. "INFO", "BLOCK", "SCALE UP").
+     * @return logMessage, cleared and holding "[tag] ".
+     */
+    LogBuffer& beginLog(const char* tag);
+
+    /**
+     * @brief Writes the message built since beginLog() to each sink that takes @p level.
+     * @param level     Level of the message.
      * @param colorCode ANSI escape code for terminal color (unused in file output).
-     * @param message   Log message body.
      */
-    void writeLog(const std::string& level, const std::string& colorCode, const std::string& message);
+    void writeLog(LogLevel level, const char* colorCode);
+
+    /**
+     * @brief Sends a per-request record to the log file: through the
+     *        AsyncLogger if there is one, else formatted and written here.
+     * @param record Record to log; ignored if there is no log file.
+     */
+    void logEvent(const LogRecord& record);
+
+    /**
+     * @brief Logs a pool change as a LOG_SCALED record (binary log only).
+     * @param delta Servers added (positive) or removed (negative).
+     */
+    void logScale(int delta);
+
+    /** @brief Appends @p record to @p out in the log file's format (binary or text). */
+    void renderRecord(const LogRecord& record, std::string& out);
 
     /**
-     * @brief Writes an informational message to the log file with the [INFO] tag.
-     * @param message Text to write.
+     * @brief Sends a text line (without newline) to the log file, in order
+     *        with logEvent() records.
+     * @param line Text to log; ignored if there is no log file.
      */
-    void logInfo(const std::string& message);
+    void logLine(std::string_view line);
 };
 
 #endif
\ No newline at end of file
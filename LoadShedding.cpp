@@ -0,0 +1,121 @@
+// LoadShedding.cpp
+
+#include "LoadShedding.h"
+#include <cmath>
+
+// RED averaging weight per arrival
+const double RED_WEIGHT = 0.002;
+
+// set up the policy, capacity and RED state
+AdmissionControl::AdmissionControl(ShedPolicy policy, int capacity, double maxProbability, unsigned int seed) {
+    shedPolicy = policy;
+    limit = capacity < 0 ? 0 : capacity;
+    maxDrop = maxProbability;
+    averageQueue = 0.0;
+    // xorshift must not start at zero
+    rngState = 0xD1B54A32D192ED03ULL ^ seed;
+    if (rngState == 0) {
+        rngState = 1;
+    }
+}
+
+// hard capacity first, then RED between half and full capacity
+AdmissionDecision AdmissionControl::decide(int queued, bool allowEarly) {
+    if (limit == 0) {
+        return ADMIT;
+    }
+
+    if (shedPolicy == SHED_RED) {
+        averageQueue += RED_WEIGHT * (queued - averageQueue);
+        double low = limit / 2.0;
+        if (allowEarly && averageQueue > low && queued < limit) {
+            double probability = maxDrop * (averageQueue - low) / (limit - low);
+            if (averageQueue >= limit || nextUniform() < probability) {
+                return REJECT_EARLY;
+            }
+        }
+    }
+
+    if (queued < limit) {
+        return ADMIT;
+    }
+    return shedPolicy == SHED_DROP_OLDEST ? ADMIT_DROP_OLDEST : REJECT_FULL;
+}
+
+// getter for capacity
+int AdmissionControl::capacity() const {
+    return limit;
+}
+
+// config name -> policy
+bool AdmissionControl::parsePolicy(const std::string& name, ShedPolicy& policy) {
+    if (name == "drop_tail") {
+        policy = SHED_DROP_TAIL;
+    } else if (name == "drop_oldest") {
+        policy = SHED_DROP_OLDEST;
+    } else if (name == "red") {
+        policy = SHED_RED;
+    } else if (name == "codel") {
+        policy = SHED_CODEL;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// xorshift64 scaled to [0, 1)
+double AdmissionControl::nextUniform() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return (double)(rngState >> 11) / 9007199254740992.0;
+}
+
+// controller starts below target and not dropping
+CoDelController::CoDelController(int target, int interval) {
+    targetDelay = target < 1 ? 1 : target;
+    window = interval < 1 ? 1 : interval;
+    firstAbove = 0.0;
+    dropNext = 0.0;
+    dropCount = 0;
+    dropping = false;
+}
+
+// CoDel: drop only after the delay stayed above target for a whole interval
+bool CoDelController::shouldDrop(int sojourn, int now) {
+    bool okToDrop = false;
+    if (sojourn < targetDelay) {
+        firstAbove = 0.0;
+    } else if (firstAbove == 0.0) {
+        firstAbove = now + window;
+    } else if (now >= firstAbove) {
+        okToDrop = true;
+    }
+
+    if (dropping) {
+        if (!okToDrop) {
+            dropping = false;
+            return false;
+        }
+        if (now >= dropNext) {
+            dropCount++;
+            dropNext = controlLaw(dropNext);
+            return true;
+        }
+        return false;
+    }
+
+    if (okToDrop) {
+        dropping = true;
+        // resume near the previous drop rate if we only just left the dropping state
+        dropCount = (dropCount > 2 && now - dropNext < 16.0 * window) ? dropCount - 2 : 1;
+        dropNext = controlLaw(now);
+        return true;
+    }
+    return false;
+}
+
+// drops get closer together as the count grows
+double CoDelController::controlLaw(double from) const {
+    return from + window / std::sqrt((double)dropCount);
+}
@@ -0,0 +1,127 @@
+/**
+ * @file LoadShedding.h
+ * @brief Defines the admission control applied to arriving requests and the
+ *        CoDel controller that sheds requests at dequeue time.
+ *
+ * @author Karan Bhagat
+ * @date 2026
+ */
+
+#ifndef LOADSHEDDING_H
+#define LOADSHEDDING_H
+
+#include <string>
+
+/**
+ * @enum ShedPolicy
+ * @brief What the load balancer does when the queue is long or full.
+ */
+enum ShedPolicy {
+    SHED_DROP_TAIL,   ///< Reject arrivals while the queue is at capacity.
+    SHED_DROP_OLDEST, ///< Drop the head of the longest shard queue to make room.
+    SHED_RED,         ///< Random early drop of arrivals, by average queue length.
+    SHED_CODEL        ///< Drop at dequeue while queue sojourn time stays above target.
+};
+
+/**
+ * @enum AdmissionDecision
+ * @brief Result of AdmissionControl::decide() for one arriving request.
+ */
+enum AdmissionDecision {
+    ADMIT,             ///< Queue the request.
+    REJECT_FULL,       ///< Drop it: the queue is at capacity.
+    REJECT_EARLY,      ///< Drop it: RED chose to shed it before the queue filled.
+    ADMIT_DROP_OLDEST  ///< Queue it after dropping one queued request.
+};
+
+/**
+ * @class AdmissionControl
+ * @brief Decides, per arrival, whether a request may enter the queue.
+ *
+ * The hard capacity applies to every policy (0 = unbounded); CoDel relies
+ * on it as the backstop for bursts that arrive faster than it can react.
+ * RED keeps an exponentially weighted average of the queue length and,
+ * once it passes half the capacity, sheds arrivals with a probability that
+ * rises linearly to @c maxProbability at full capacity. Decisions use a
+ * private generator so shedding never perturbs request generation.
+ */
+class AdmissionControl {
+public:
+    /**
+     * @param policy         Shedding policy.
+     * @param capacity       Maximum queued requests (0 = unbounded).
+     * @param maxProbability RED drop probability as the average reaches capacity.
+     * @param seed           Seed for RED's random drops.
+     */
+    AdmissionControl(ShedPolicy policy, int capacity, double maxProbability, unsigned int seed);
+
+    /**
+     * @brief Decides what to do with one arrival.
+     * @param queued     Requests currently queued across all shards.
+     * @param allowEarly @c false to skip RED (e.g. while filling the initial queue).
+     * @return The admission decision.
+     */
+    AdmissionDecision decide(int queued, bool allowEarly);
+
+    /** @brief Maximum queued requests, or 0 if unbounded. */
+    int capacity() const;
+
+    /**
+     * @brief Parses a shedding policy name from the config file.
+     * @param name   One of @c drop_tail, @c drop_oldest, @c red, @c codel.
+     * @param policy Output parameter set on success.
+     * @return @c true if @p name was recognised.
+     */
+    static bool parsePolicy(const std::string& name, ShedPolicy& policy);
+
+private:
+    ShedPolicy shedPolicy;       ///< Policy in use.
+    int limit;                   ///< Capacity, 0 = unbounded.
+    double maxDrop;              ///< RED maximum drop probability.
+    double averageQueue;         ///< RED's EWMA of the queue length.
+    unsigned long long rngState; ///< xorshift64 state.
+
+    /** @brief Returns a uniform random number in [0, 1). */
+    double nextUniform();
+};
+
+/**
+ * @class CoDelController
+ * @brief Controlled-delay shedding driven by how long the head request has
+ *        been queued.
+ *
+ * Follows the CoDel state machine: once the head's sojourn time has stayed
+ * above @c target for a full @c interval the controller starts dropping
+ * head requests, spacing drops by interval / sqrt(drop count) so shedding
+ * grows until the delay falls back under target. One controller per Shard,
+ * used only by that shard's thread.
+ */
+class CoDelController {
+public:
+    /**
+     * @param target   Acceptable standing queue delay, in cycles.
+     * @param interval Window the delay must exceed target for before dropping, in cycles.
+     */
+    CoDelController(int target = 100, int interval = 1000);
+
+    /**
+     * @brief Called with the head request before it is dispatched.
+     * @param sojourn Cycles the head request has been queued.
+     * @param now     Current simulation cycle.
+     * @return @c true if the head should be dropped instead of dispatched.
+     */
+    bool shouldDrop(int sojourn, int now);
+
+private:
+    int targetDelay;       ///< Target sojourn time.
+    int window;            ///< Interval.
+    double firstAbove;     ///< Cycle at which delay will have been above target for a full interval (0 = below).
+    double dropNext;       ///< Cycle of the next drop while dropping.
+    int dropCount;         ///< Drops in the current dropping state.
+    bool dropping;         ///< Whether the controller is in the dropping state.
+
+    /** @brief Next drop time after @p from given the current drop count. */
+    double controlLaw(double from) const;
+};
+
+#endif
@@ -0,0 +1,74 @@
+// LogBuffer.cpp
+
+#include "LogBuffer.h"
+#include <charconv>
+
+// reserve once; clear() never gives it back
+LogBuffer::LogBuffer(size_t capacity) {
+    text.reserve(capacity);
+}
+
+// length 0, capacity kept
+void LogBuffer::clear() {
+    text.clear();
+}
+
+// getter for bytes written
+size_t LogBuffer::size() const {
+    return text.size();
+}
+
+// drop everything past length
+void LogBuffer::truncate(size_t length) {
+    if (length < text.size()) {
+        text.resize(length);
+    }
+}
+
+// read-only view of the contents
+std::string_view LogBuffer::view() const {
+    return text;
+}
+
+// null-terminated text
+LogBuffer& LogBuffer::operator<<(const char* value) {
+    text += value;
+    return *this;
+}
+
+// std::string and friends
+LogBuffer& LogBuffer::operator<<(std::string_view value) {
+    text.append(value.data(), value.size());
+    return *this;
+}
+
+// single character
+LogBuffer& LogBuffer::operator<<(char c) {
+    text += c;
+    return *this;
+}
+
+// int through the long long path
+LogBuffer& LogBuffer::operator<<(int value) {
+    return *this << (long long)value;
+}
+
+// digits into a stack buffer, then appended
+LogBuffer& LogBuffer::operator<<(long long value) {
+    char digits[24];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    text.append(digits, result.ptr - digits);
+    return *this;
+}
+
+// same for doubles, with a fixed number of decimals
+LogBuffer& LogBuffer::fixed(double value, int decimals) {
+    char digits[64];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed, decimals);
+    if (result.ec != std::errc()) {
+        // too wide for the stack buffer (|value| > 1e60 or so)
+        return *this << "inf";
+    }
+    text.append(digits, result.ptr - digits);
+    return *this;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file LogBuffer.h
+ * @brief Defines LogBuffer, a reusable text buffer that log messages are
+ *        formatted into without temporary strings.
+ *
+ * @author Karan Bhagat
+ * @date 2026
+ */
+
+#ifndef LOGBUFFER_H
+#define LOGBUFFER_H
+
+#include <string>
+#include <string_view>
+
+/**
+ * @class LogBuffer
+ * @brief Typed, append-only message builder backed by one reused string.
+ *
+ * Numbers are written in place with @c std::to_chars and text is copied
+ * straight in, so building a message makes no temporaries. clear() keeps the
+ * capacity, so once the buffer has grown to fit the longest message a
+ * logger writes, formatting allocates nothing at all.
+ *
+ * @code
+ * buffer.clear();
+ * buffer << "Cycle " << cycle << ": queue " << queued << '/' << capacity;
+ * @endcode
+ */
+class LogBuffer {
+public:
+    /**
+     * @brief Constructor.
+     * @param capacity Bytes reserved up front.
+     */
+    explicit LogBuffer(size_t capacity = 256);
+
+    /** @brief Empties the buffer, keeping its capacity. */
+    void clear();
+
+    /** @brief Bytes written so far. */
+    size_t size() const;
+
+    /** @brief Cuts the buffer back to its first @p length bytes. */
+    void truncate(size_t length);
+
+    /** @brief Contents, valid until the next write. */
+    std::string_view view() const;
+
+    LogBuffer& operator<<(const char* text);
+    LogBuffer& operator<<(std::string_view text);
+    LogBuffer& operator<<(char c);
+    LogBuffer& operator<<(int value);
+    LogBuffer& operator<<(long long value);
+
+    /**
+     * @brief Appends @p value in fixed notation.
+     * @param value    Number to write.
+     * @param decimals Digits after the decimal point.
+     */
+    LogBuffer& fixed(double value, int decimals);
+
+private:
+    std::string text; ///< Contents; capacity is kept across clear().
+};
+
+#endif
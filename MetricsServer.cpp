@@ -0,0 +1,315 @@
+// MetricsServer.cpp
+
+#include "MetricsServer.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+const int MAX_CONNECTIONS = 64;       // further clients wait in the listen backlog
+const size_t MAX_REQUEST_BYTES = 8192;
+const int POLL_TIMEOUT_MS = 50;       // how often the loop looks at the stop flag
+const int IDLE_TIMEOUT_MS = 5000;     // clients that never finish their request are dropped
+
+// non-blocking, so accept/recv/send return EAGAIN instead of stalling the loop
+bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// "# HELP", "# TYPE" and the sample line of one metric
+void appendMetric(std::string& out, const char* name, const char* type, const char* help, const std::string& value) {
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+    out += name;
+    out += ' ';
+    out += value;
+    out += '\n';
+}
+
+// compact text for a double (up to 9 significant digits)
+std::string formatDouble(double value) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.9g", value);
+    return buf;
+}
+
+// "key":value, with a leading comma after the first field
+void appendField(std::string& out, const char* key, const std::string& value) {
+    if (out.back() != '{') {
+        out += ',';
+    }
+    out += '"';
+    out += key;
+    out += "\":";
+    out += value;
+}
+
+} // namespace
+
+// nothing listening until start()
+MetricsServer::MetricsServer() : stopping(false) {
+    listenFd = -1;
+    publishCount = 0;
+    scrapeCount = 0;
+}
+
+// joins the thread if the caller did not
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+// bind to loopback only, then hand the socket to the server thread
+bool MetricsServer::start(int port, std::string& error) {
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        error = strerror(errno);
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons((uint16_t)port);
+    if (bind(listenFd, (sockaddr*)&address, sizeof(address)) != 0 || listen(listenFd, 16) != 0 || !setNonBlocking(listenFd)) {
+        error = strerror(errno);
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    server = std::thread(&MetricsServer::serveLoop, this);
+    return true;
+}
+
+// the loop notices the flag within one poll timeout
+void MetricsServer::stop() {
+    stopping.store(true, std::memory_order_relaxed);
+    if (server.joinable()) {
+        server.join();
+    }
+    if (listenFd >= 0) {
+        close(listenFd);
+        listenFd = -1;
+    }
+}
+
+// the simulation fills this in place, no copy
+MetricsSnapshot& MetricsServer::writeSlot() {
+    return snapshots.writeSlot();
+}
+
+// one atomic exchange; never waits for the server thread
+void MetricsServer::publish() {
+    snapshots.publish();
+    publishCount++;
+}
+
+// getter for snapshots published
+long long MetricsServer::published() const {
+    return publishCount;
+}
+
+// getter for responses sent
+long long MetricsServer::scrapes() const {
+    return scrapeCount;
+}
+
+// gauges for current state, counters (suffix _total) for running totals
+void MetricsServer::formatPrometheus(const MetricsSnapshot& s, std::string& out) {
+    appendMetric(out, "lb_cycle", "gauge", "Last simulated cycle.", std::to_string(s.cycle));
+    appendMetric(out, "lb_cycles_planned", "gauge", "Cycles the run will simulate.", std::to_string(s.totalCycles));
+    appendMetric(out, "lb_requests_generated_total", "counter", "Requests created, blocked ones included.", std::to_string(s.generated));
+    appendMetric(out, "lb_requests_accepted_total", "counter", "Requests admitted to the queue.", std::to_string(s.accepted));
+    appendMetric(out, "lb_requests_blocked_total", "counter", "Requests rejected by the firewall.", std::to_string(s.blocked));
+    appendMetric(out, "lb_requests_shed_total", "counter", "Requests shed by admission control.", std::to_string(s.shed));
+    appendMetric(out, "lb_requests_timed_out_total", "counter", "Requests whose client gave up while queued.", std::to_string(s.timedOut));
+    appendMetric(out, "lb_requests_completed_total", "counter", "Requests finished.", std::to_string(s.completed));
+    appendMetric(out, "lb_queue_size", "gauge", "Requests waiting.", std::to_string(s.queued));
+    appendMetric(out, "lb_servers", "gauge", "Servers in the pool.", std::to_string(s.servers));
+    appendMetric(out, "lb_servers_busy", "gauge", "Servers with an active request in the last cycle.", std::to_string(s.busyServers));
+    appendMetric(out, "lb_servers_pending", "gauge", "Servers still booting.", std::to_string(s.pendingServers));
+    appendMetric(out, "lb_servers_draining", "gauge", "Servers draining before removal.", std::to_string(s.drainingServers));
+    appendMetric(out, "lb_scale_ups_total", "counter", "Scale-up events.", std::to_string(s.scaleUps));
+    appendMetric(out, "lb_scale_downs_total", "counter", "Scale-down events.", std::to_string(s.scaleDowns));
+    appendMetric(out, "lb_queue_wait_mean_cycles", "gauge", "Mean queue wait so far, in cycles.", formatDouble(s.waitMean));
+    appendMetric(out, "lb_queue_wait_p99_cycles", "gauge", "p99 queue wait so far, in cycles.", std::to_string(s.waitP99));
+    appendMetric(out, "lb_response_p99_cycles", "gauge", "p99 response time so far, in cycles.", std::to_string(s.responseP99));
+    appendMetric(out, "lb_wall_seconds", "gauge", "Wall time since the cycle loop started.", formatDouble(s.wallSeconds));
+}
+
+// same fields, flat object
+void MetricsServer::formatJson(const MetricsSnapshot& s, std::string& out) {
+    out += '{';
+    appendField(out, "cycle", std::to_string(s.cycle));
+    appendField(out, "total_cycles", std::to_string(s.totalCycles));
+    appendField(out, "generated", std::to_string(s.generated));
+    appendField(out, "accepted", std::to_string(s.accepted));
+    appendField(out, "blocked", std::to_string(s.blocked));
+    appendField(out, "shed", std::to_string(s.shed));
+    appendField(out, "timed_out", std::to_string(s.timedOut));
+    appendField(out, "completed", std::to_string(s.completed));
+    appendField(out, "queue", std::to_string(s.queued));
+    appendField(out, "servers", std::to_string(s.servers));
+    appendField(out, "busy_servers", std::to_string(s.busyServers));
+    appendField(out, "pending_servers", std::to_string(s.pendingServers));
+    appendField(out, "draining_servers", std::to_string(s.drainingServers));
+    appendField(out, "scale_ups", std::to_string(s.scaleUps));
+    appendField(out, "scale_downs", std::to_string(s.scaleDowns));
+    appendField(out, "wait_mean", formatDouble(s.waitMean));
+    appendField(out, "wait_p99", std::to_string(s.waitP99));
+    appendField(out, "response_p99", std::to_string(s.responseP99));
+    appendField(out, "wall_seconds", formatDouble(s.wallSeconds));
+    appendField(out, "cycles_per_second", formatDouble(s.wallSeconds > 0 ? s.cycle / s.wallSeconds : 0.0));
+    out += "}\n";
+}
+
+// poll the listener and every client; accept, read and write whatever is ready
+void MetricsServer::serveLoop() {
+    std::vector<pollfd> fds;
+    while (!stopping.load(std::memory_order_relaxed)) {
+        fds.clear();
+        pollfd listener = {listenFd, (short)((int)connections.size() < MAX_CONNECTIONS ? POLLIN : 0), 0};
+        fds.push_back(listener);
+        for (int i = 0; i < (int)connections.size(); i++) {
+            pollfd client = {connections[i].fd, (short)(connections[i].out.empty() ? POLLIN : POLLOUT), 0};
+            fds.push_back(client);
+        }
+        if (poll(fds.data(), fds.size(), POLL_TIMEOUT_MS) < 0 && errno != EINTR) {
+            break;
+        }
+
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        // walk backwards so closing one does not shift the ones not yet visited
+        for (int i = (int)connections.size() - 1; i >= 0; i--) {
+            Connection& connection = connections[i];
+            short events = fds[i + 1].revents;
+            bool open = true;
+            if (events & (POLLERR | POLLHUP | POLLNVAL)) {
+                open = false;
+            } else if (events & POLLIN) {
+                open = readRequest(connection);
+            } else if (events & POLLOUT) {
+                open = writeResponse(connection);
+            } else if (now - connection.opened > std::chrono::milliseconds(IDLE_TIMEOUT_MS)) {
+                open = false;
+            }
+            if (!open) {
+                close(connection.fd);
+                connections.erase(connections.begin() + i);
+            }
+        }
+
+        if (fds[0].revents & POLLIN) {
+            while ((int)connections.size() < MAX_CONNECTIONS) {
+                int fd = accept(listenFd, nullptr, nullptr);
+                if (fd < 0) {
+                    break;
+                }
+                if (!setNonBlocking(fd)) {
+                    close(fd);
+                    continue;
+                }
+                Connection connection;
+                connection.fd = fd;
+                connection.sent = 0;
+                connection.opened = now;
+                connections.push_back(connection);
+            }
+        }
+    }
+    for (int i = 0; i < (int)connections.size(); i++) {
+        close(connections[i].fd);
+    }
+    connections.clear();
+}
+
+// read until the blank line that ends the request head, then build the response
+bool MetricsServer::readRequest(Connection& connection) {
+    char buf[1024];
+    ssize_t n = recv(connection.fd, buf, sizeof(buf), 0);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        return false;
+    }
+    if (n > 0) {
+        connection.in.append(buf, n);
+    }
+    bool complete = connection.in.find("\r\n\r\n") != std::string::npos || connection.in.find("\n\n") != std::string::npos;
+    if (complete || connection.in.size() > MAX_REQUEST_BYTES) {
+        respond(complete ? connection.in : std::string(), connection.out);
+        // try right away; most responses fit the socket buffer in one send
+        return writeResponse(connection);
+    }
+    return true;
+}
+
+// send what fits; the connection is done once everything is out
+bool MetricsServer::writeResponse(Connection& connection) {
+    while (connection.sent < connection.out.size()) {
+        ssize_t n = send(connection.fd, connection.out.data() + connection.sent, connection.out.size() - connection.sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        connection.sent += n;
+    }
+    scrapeCount++;
+    return false;
+}
+
+// route on the request line; bodies come from the newest snapshot
+void MetricsServer::respond(const std::string& request, std::string& out) {
+    std::string line = request.substr(0, request.find_first_of("\r\n"));
+    std::string method = line.substr(0, line.find(' '));
+    std::string path;
+    size_t pathStart = line.find(' ');
+    if (pathStart != std::string::npos) {
+        path = line.substr(pathStart + 1, line.find(' ', pathStart + 1) - pathStart - 1);
+        path = path.substr(0, path.find('?'));
+    }
+
+    const char* status = "200 OK";
+    const char* contentType = "text/plain; charset=utf-8";
+    std::string body;
+    if (request.empty()) {
+        status = "400 Bad Request";
+        body = "bad request\n";
+    } else if (method != "GET") {
+        status = "405 Method Not Allowed";
+        body = "only GET is supported\n";
+    } else if (path == "/metrics") {
+        snapshots.update();
+        contentType = "text/plain; version=0.0.4; charset=utf-8";
+        formatPrometheus(snapshots.read(), body);
+    } else if (path == "/status") {
+        snapshots.update();
+        contentType = "application/json";
+        formatJson(snapshots.read(), body);
+    } else {
+        status = "404 Not Found";
+        body = "try /metrics or /status\n";
+    }
+
+    out = "HTTP/1.1 ";
+    out += status;
+    out += "\r\nContent-Type: ";
+    out += contentType;
+    out += "\r\nContent-Length: ";
+    out += std::to_string(body.size());
+    out += "\r\nConnection: close\r\n\r\n";
+    out += body;
+}
@@ -0,0 +1,152 @@
+/**
+ * @file MetricsServer.h
+ * @brief Defines MetricsSnapshot and the MetricsServer class, an embedded
+ *        HTTP endpoint serving live simulation metrics on localhost.
+ *
+ * @author Karan Bhagat
+ * @date 2026
+ */
+
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TripleBuffer.h"
+
+/**
+ * @struct MetricsSnapshot
+ * @brief Counters the simulation publishes for the metrics endpoint.
+ */
+struct MetricsSnapshot {
+    int cycle;              ///< Last cycle completed.
+    int totalCycles;        ///< Cycles the run will simulate.
+    long long generated;    ///< Requests created (blocked ones included).
+    long long accepted;     ///< Requests admitted to the queue.
+    long long blocked;      ///< Requests rejected by the firewall.
+    long long shed;         ///< Requests shed (queue full, RED, drop-oldest, CoDel).
+    long long timedOut;     ///< Requests whose client gave up in the queue.
+    long long completed;    ///< Requests finished.
+    int queued;             ///< Requests waiting now.
+    int servers;            ///< Servers in the pool.
+    int busyServers;        ///< Servers with an active request in the last cycle.
+    int pendingServers;     ///< Servers still booting.
+    int drainingServers;    ///< Servers draining before removal.
+    int scaleUps;           ///< Scale-up events so far.
+    int scaleDowns;         ///< Scale-down events so far.
+    double waitMean;        ///< Mean queue wait so far, in cycles.
+    int waitP99;            ///< p99 queue wait so far, in cycles.
+    int responseP99;        ///< p99 response time so far, in cycles.
+    double wallSeconds;     ///< Wall time since the cycle loop started.
+
+    MetricsSnapshot() {
+        cycle = 0;
+        totalCycles = 0;
+        generated = 0;
+        accepted = 0;
+        blocked = 0;
+        shed = 0;
+        timedOut = 0;
+        completed = 0;
+        queued = 0;
+        servers = 0;
+        busyServers = 0;
+        pendingServers = 0;
+        drainingServers = 0;
+        scaleUps = 0;
+        scaleDowns = 0;
+        waitMean = 0.0;
+        waitP99 = 0;
+        responseP99 = 0;
+        wallSeconds = 0.0;
+    }
+};
+
+/**
+ * @class MetricsServer
+ * @brief Single-threaded, non-blocking HTTP server on 127.0.0.1.
+ *
+ * Serves @c GET @c /metrics (Prometheus text format) and @c GET @c /status
+ * (JSON) from the latest MetricsSnapshot. The simulation thread fills
+ * writeSlot() and calls publish(); the server thread picks the newest
+ * snapshot up through a TripleBuffer, so neither side ever waits for the
+ * other and a slow or stuck client cannot stall the simulation loop.
+ *
+ * All sockets are non-blocking and multiplexed with poll() on the one
+ * server thread; each connection gets one response and is closed.
+ */
+class MetricsServer {
+public:
+    MetricsServer();
+
+    /** @brief Destructor. Calls stop(). */
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    /**
+     * @brief Binds 127.0.0.1:@p port and starts the server thread.
+     * @param port  TCP port to listen on.
+     * @param error Output parameter set to the reason on failure.
+     * @return @c true if the server is listening.
+     */
+    bool start(int port, std::string& error);
+
+    /** @brief Stops the server thread and closes every socket. Idempotent. */
+    void stop();
+
+    /** @brief Simulation side: the snapshot to fill before publish(). */
+    MetricsSnapshot& writeSlot();
+
+    /** @brief Simulation side: makes the filled snapshot visible to scrapes. */
+    void publish();
+
+    /** @brief Snapshots published. */
+    long long published() const;
+
+    /** @brief Requests answered (valid after stop()). */
+    long long scrapes() const;
+
+    /** @brief Appends @p snapshot in Prometheus text exposition format. */
+    static void formatPrometheus(const MetricsSnapshot& snapshot, std::string& out);
+
+    /** @brief Appends @p snapshot as a JSON object. */
+    static void formatJson(const MetricsSnapshot& snapshot, std::string& out);
+
+private:
+    /** @brief One accepted client. */
+    struct Connection {
+        int fd;            ///< Socket.
+        std::string in;    ///< Request bytes read so far.
+        std::string out;   ///< Response, once built.
+        size_t sent;       ///< Bytes of @c out already sent.
+        std::chrono::steady_clock::time_point opened; ///< Accept time, for the idle timeout.
+    };
+
+    /** @brief Server thread: poll, accept, read, respond until stopped. */
+    void serveLoop();
+
+    /** @brief Reads what is available; builds the response once the request head is in. */
+    bool readRequest(Connection& connection);
+
+    /** @brief Sends what the socket takes; @c false once done or failed. */
+    bool writeResponse(Connection& connection);
+
+    /** @brief Full HTTP response for a request line. */
+    void respond(const std::string& request, std::string& out);
+
+    TripleBuffer<MetricsSnapshot> snapshots; ///< Simulation -> server exchange.
+    int listenFd;                            ///< Listening socket, or -1.
+    std::thread server;                      ///< The server thread.
+    std::atomic<bool> stopping;              ///< Set by stop().
+    std::vector<Connection> connections;     ///< Open clients (server thread only).
+    long long publishCount;                  ///< Snapshots published (simulation side).
+    long long scrapeCount;                   ///< Responses sent (server side).
+};
+
+#endif
@@ -0,0 +1,153 @@
+// Pipeline.cpp
+
+#include "Pipeline.h"
+#include <chrono>
+
+typedef std::chrono::steady_clock Clock;
+
+// seconds elapsed since the given time point
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// push an item, yielding while the ring is full; returns time spent waiting
+static double pushWaiting(SpscRing<PipelineItem>& ring, PipelineItem& item) {
+    if (ring.tryPush(item)) {
+        return 0.0;
+    }
+    Clock::time_point start = Clock::now();
+    while (!ring.tryPush(item)) {
+        std::this_thread::yield();
+    }
+    return secondsSince(start);
+}
+
+// pop an item, yielding while the ring is empty; returns time spent waiting
+static double popWaiting(SpscRing<PipelineItem>& ring, PipelineItem& item) {
+    if (ring.tryPop(item)) {
+        return 0.0;
+    }
+    Clock::time_point start = Clock::now();
+    while (!ring.tryPop(item)) {
+        std::this_thread::yield();
+    }
+    return secondsSince(start);
+}
+
+// both rings get the same capacity
+RequestPipeline::RequestPipeline(int ringCapacity) : generated(ringCapacity), filtered(ringCapacity) {
+}
+
+// make sure the threads are gone
+RequestPipeline::~RequestPipeline() {
+    if (generatorThread.joinable()) {
+        generatorThread.join();
+    }
+    if (filterThread.joinable()) {
+        filterThread.join();
+    }
+}
+
+// launch the generator and filter threads
+void RequestPipeline::start(int cycles, std::function<void(std::vector<Request>&)> generate, std::function<bool(const std::string&)> isBlocked) {
+    generatorThread = std::thread(&RequestPipeline::generatorLoop, this, cycles, generate);
+    filterThread = std::thread(&RequestPipeline::filterLoop, this, isBlocked);
+}
+
+// produce each cycle's arrivals followed by an end-of-cycle marker
+void RequestPipeline::generatorLoop(int cycles, std::function<void(std::vector<Request>&)> generate) {
+    StageStats& stage = stages[0];
+    std::vector<Request> arrivals;
+    PipelineItem item;
+
+    for (int cycle = 1; cycle <= cycles; cycle++) {
+        Clock::time_point start = Clock::now();
+        arrivals.clear();
+        generate(arrivals);
+        stage.busySeconds += secondsSince(start);
+
+        for (int i = 0; i < (int)arrivals.size(); i++) {
+            item.request = arrivals[i];
+            item.cycle = cycle;
+            item.blocked = false;
+            item.endOfCycle = false;
+            stage.outputWaitSeconds += pushWaiting(generated, item);
+            stage.items++;
+        }
+
+        item.cycle = cycle;
+        item.endOfCycle = true;
+        stage.outputWaitSeconds += pushWaiting(generated, item);
+    }
+
+    // cycle 0 marker tells the filter there is nothing more to come
+    item.cycle = 0;
+    item.endOfCycle = true;
+    stage.outputWaitSeconds += pushWaiting(generated, item);
+}
+
+// run the firewall check on every request and pass everything along
+void RequestPipeline::filterLoop(std::function<bool(const std::string&)> isBlocked) {
+    StageStats& stage = stages[1];
+    PipelineItem item;
+
+    while (true) {
+        stage.inputWaitSeconds += popWaiting(generated, item);
+        if (item.endOfCycle && item.cycle == 0) {
+            return;
+        }
+
+        if (!item.endOfCycle) {
+            Clock::time_point start = Clock::now();
+            item.blocked = isBlocked(item.request.ipIn);
+            stage.busySeconds += secondsSince(start);
+            stage.items++;
+        }
+        stage.outputWaitSeconds += pushWaiting(filtered, item);
+    }
+}
+
+// collect one cycle's worth of filtered requests
+void RequestPipeline::receiveCycle(int cycle, std::vector<PipelineItem>& out) {
+    StageStats& stage = stages[2];
+    out.clear();
+
+    PipelineItem item;
+    while (true) {
+        stage.inputWaitSeconds += popWaiting(filtered, item);
+        if (item.endOfCycle && item.cycle == cycle) {
+            return;
+        }
+        out.push_back(item);
+        stage.items++;
+    }
+}
+
+// join the threads and work out how long dispatch was actually busy
+void RequestPipeline::stop(double dispatchWallSeconds) {
+    if (generatorThread.joinable()) {
+        generatorThread.join();
+    }
+    if (filterThread.joinable()) {
+        filterThread.join();
+    }
+
+    double busy = dispatchWallSeconds - stages[2].inputWaitSeconds;
+    stages[2].busySeconds = busy > 0.0 ? busy : 0.0;
+}
+
+// getter for stage timing
+const StageStats* RequestPipeline::stageStats() const {
+    return stages;
+}
+
+// display names for the report
+std::string RequestPipeline::stageName(int stage) {
+    if (stage == 0) {
+        return "generate";
+    }
+    if (stage == 1) {
+        return "filter";
+    }
+    return "dispatch";
+}
@@ -0,0 +1,146 @@
+/**
+ * @file Pipeline.h
+ * @brief Defines the RequestPipeline class that runs request generation and
+ *        firewall filtering on their own threads, ahead of dispatch.
+ *
+ * @author Karan Bhagat
+ * @date 2026
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Request.h"
+#include "RingBuffer.h"
+
+/**
+ * @struct StageStats
+ * @brief Time accounting for one pipeline stage.
+ *
+ * Busy time is spent doing the stage's own work; input wait is time spent
+ * on an empty upstream ring and output wait is time spent on a full
+ * downstream ring (back-pressure).
+ */
+struct StageStats {
+    long long items;          ///< Requests handled by the stage.
+    double busySeconds;       ///< Time spent doing useful work.
+    double inputWaitSeconds;  ///< Time spent waiting for upstream items.
+    double outputWaitSeconds; ///< Time spent waiting for downstream room.
+
+    StageStats() {
+        items = 0;
+        busySeconds = 0.0;
+        inputWaitSeconds = 0.0;
+        outputWaitSeconds = 0.0;
+    }
+
+    /**
+     * @brief Fraction of the stage's wall time spent busy.
+     * @return Value in [0, 1]; 0 if the stage never ran.
+     */
+    double utilization() const {
+        double total = busySeconds + inputWaitSeconds + outputWaitSeconds;
+        return total > 0.0 ? busySeconds / total : 0.0;
+    }
+};
+
+/**
+ * @struct PipelineItem
+ * @brief One entry travelling between pipeline stages.
+ *
+ * Either a generated request (with the filter stage's verdict once it has
+ * been through the firewall) or an end-of-cycle marker that tells the
+ * dispatch stage every arrival for @c cycle has been delivered.
+ */
+struct PipelineItem {
+    Request request;  ///< The generated request (unused for markers).
+    int cycle;        ///< Simulation cycle the request arrives in.
+    bool blocked;     ///< Set by the filter stage when the source IP is blocked.
+    bool endOfCycle;  ///< @c true for the marker closing @c cycle.
+
+    PipelineItem() {
+        cycle = 0;
+        blocked = false;
+        endOfCycle = false;
+    }
+};
+
+/**
+ * @class RequestPipeline
+ * @brief Three-stage pipeline: generate -> filter -> dispatch.
+ *
+ * The generator thread produces each cycle's arrivals, the filter thread
+ * runs the firewall check, and the dispatch stage (the caller's thread)
+ * pulls one cycle at a time with receiveCycle(). Stages are connected by
+ * bounded SpscRing buffers; a stage that finds its output ring full waits,
+ * which throttles everything upstream of a slow stage. Because each ring
+ * preserves order and only the generator thread draws random numbers, the
+ * request stream is identical to the serial loop's.
+ */
+class RequestPipeline {
+public:
+    /** @brief Number of stages tracked in stageStats(). */
+    static const int STAGE_COUNT = 3;
+
+    /**
+     * @brief Constructs an idle pipeline.
+     * @param ringCapacity Slots in each inter-stage ring buffer.
+     */
+    RequestPipeline(int ringCapacity);
+
+    /**
+     * @brief Destructor. Joins the stage threads if they are still running.
+     */
+    ~RequestPipeline();
+
+    /**
+     * @brief Starts the generator and filter threads.
+     * @param cycles    Number of cycles the generator should produce.
+     * @param generate  Appends the arrivals for one cycle to its argument.
+     * @param isBlocked Firewall check applied to each request's source IP.
+     */
+    void start(int cycles, std::function<void(std::vector<Request>&)> generate, std::function<bool(const std::string&)> isBlocked);
+
+    /**
+     * @brief Dispatch side: collects every arrival for @p cycle, waiting for
+     *        the upstream stages if necessary.
+     * @param cycle Cycle to receive; must be called with 1, 2, 3, ... in order.
+     * @param out   Cleared, then filled with the cycle's filtered requests.
+     */
+    void receiveCycle(int cycle, std::vector<PipelineItem>& out);
+
+    /**
+     * @brief Joins the stage threads and finalises the dispatch stage's timing.
+     * @param dispatchWallSeconds Total wall time of the dispatch loop.
+     */
+    void stop(double dispatchWallSeconds);
+
+    /**
+     * @brief Returns timing for generate (0), filter (1) and dispatch (2).
+     * @return Pointer to an array of STAGE_COUNT entries.
+     */
+    const StageStats* stageStats() const;
+
+    /** @brief Human-readable name of stage @p stage. */
+    static std::string stageName(int stage);
+
+private:
+    SpscRing<PipelineItem> generated; ///< Generator -> filter.
+    SpscRing<PipelineItem> filtered;  ///< Filter -> dispatch.
+    std::thread generatorThread;      ///< Runs generatorLoop().
+    std::thread filterThread;         ///< Runs filterLoop().
+    StageStats stages[STAGE_COUNT];   ///< Per-stage timing; each entry written by one thread.
+
+    /** @brief Generator stage body. */
+    void generatorLoop(int cycles, std::function<void(std::vector<Request>&)> generate);
+
+    /** @brief Filter stage body. */
+    void filterLoop(std::function<bool(const std::string&)> isBlocked);
+};
+
+#endif
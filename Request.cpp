@@ -10,6 +10,10 @@ Request::Request() {
     ipOut = "0.0.0.0";
     timeRequired = 0;
     jobType = 'P';
+    enqueueTime = 0;
+    startTime = -1;
+    timeout = -1;
+    contentKey = -1;
 }
 
 // generates a random IP address like "192.168.1.55"
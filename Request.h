@@ -27,6 +27,10 @@ struct Request {
     std::string ipOut;   ///< Destination (server) IP address in dotted-decimal notation.
     int timeRequired;    ///< Number of clock cycles needed to process this request.
     char jobType;        ///< Workload category: @c 'P' for processing, @c 'S' for streaming.
+    int enqueueTime;     ///< Cycle the request entered the queue (0 for the initial fill).
+    int startTime;       ///< Cycle the request was first dispatched (-1 while never started).
+    int timeout;         ///< Cycles the client waits before giving up (-1 = waits forever).
+    long long contentKey; ///< Key the server's response cache is looked up by (-1 = not cacheable).
 
     /**
      * @brief Default constructor. Initializes all fields to safe zero/empty values.
@@ -0,0 +1,210 @@
+// RequestQueue.cpp
+
+#include "RequestQueue.h"
+#include <utility>
+
+// one bucket for FIFO, otherwise one per key up to maxTime
+RequestQueue::RequestQueue(QueueDiscipline discipline, int maxTime, int intervalWidth) {
+    order = discipline;
+    width = intervalWidth < 1 ? 1 : intervalWidth;
+    if (maxTime < 0) {
+        maxTime = 0;
+    }
+
+    int bucketCount = 1;
+    if (order == QUEUE_SJF || order == QUEUE_SRPT) {
+        bucketCount = maxTime + 1;
+    } else if (order == QUEUE_SIZE_INTERVAL) {
+        bucketCount = maxTime / width + 1;
+    }
+
+    buckets.resize(bucketCount);
+    headSeq.assign(bucketCount, 0);
+    occupied.assign((bucketCount + 63) / 64, 0);
+    lowest = 0;
+    count = 0;
+    swept = -1;
+    indexed = 0;
+}
+
+// append to the request's bucket and keep the lowest index current
+void RequestQueue::push(const Request& request) {
+    int key = keyFor(request);
+    Entry entry;
+    entry.request = request;
+    entry.live = true;
+    buckets[key].push_back(entry);
+    occupied[key / 64] |= 1ULL << (key % 64);
+    if (count == 0 || key < lowest) {
+        lowest = key;
+    }
+    count++;
+    // a resumed (preempted) request has started, so it can no longer expire
+    if (request.timeout >= 0 && request.startTime < 0) {
+        indexDeadline(key, headSeq[key] + (long long)buckets[key].size() - 1, request.enqueueTime + request.timeout);
+    }
+}
+
+// head of the lowest non-empty bucket
+const Request& RequestQueue::front() const {
+    return buckets[lowest].front().request;
+}
+
+// remove the head, moving on to the next bucket if this one is now empty
+void RequestQueue::pop() {
+    popBucket(lowest);
+    count--;
+    if (buckets[lowest].empty()) {
+        occupied[lowest / 64] &= ~(1ULL << (lowest % 64));
+        if (count > 0) {
+            lowest = nextOccupied(lowest + 1);
+        }
+    }
+}
+
+// drain the deadline slots up to this cycle; entries whose request already left are skipped
+int RequestQueue::removeExpired(int cycle, std::vector<Request>& expired) {
+    int removed = 0;
+    while (swept < cycle && indexed > 0) {
+        swept++;
+        std::vector<Deadline>& slot = deadlines[swept & ((int)deadlines.size() - 1)];
+        for (int i = 0; i < (int)slot.size(); i++) {
+            int key = slot[i].key;
+            long long offset = slot[i].seq - headSeq[key];
+            indexed--;
+            if (offset < 0 || !buckets[key][offset].live) {
+                continue;
+            }
+            Entry& entry = buckets[key][offset];
+            expired.push_back(std::move(entry.request));
+            removed++;
+            if (offset == 0) {
+                popBucket(key);
+                if (buckets[key].empty()) {
+                    occupied[key / 64] &= ~(1ULL << (key % 64));
+                }
+            } else {
+                entry.live = false;
+            }
+        }
+        slot.clear();
+    }
+    // nothing indexed, so the slots in between are empty
+    if (swept < cycle) {
+        swept = cycle;
+    }
+    count -= removed;
+    if (count > 0 && removed > 0) {
+        lowest = nextOccupied(lowest);
+    }
+    return removed;
+}
+
+// true if nothing is queued
+bool RequestQueue::empty() const {
+    return count == 0;
+}
+
+// getter for queue depth
+int RequestQueue::size() const {
+    return count;
+}
+
+// getter for the discipline
+QueueDiscipline RequestQueue::discipline() const {
+    return order;
+}
+
+// config name -> discipline
+bool RequestQueue::parseDiscipline(const std::string& name, QueueDiscipline& discipline) {
+    if (name == "fifo") {
+        discipline = QUEUE_FIFO;
+    } else if (name == "sjf") {
+        discipline = QUEUE_SJF;
+    } else if (name == "srpt") {
+        discipline = QUEUE_SRPT;
+    } else if (name == "size_interval") {
+        discipline = QUEUE_SIZE_INTERVAL;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// bucket index for a request under the current discipline
+int RequestQueue::keyFor(const Request& request) const {
+    if (order == QUEUE_FIFO) {
+        return 0;
+    }
+
+    int key = request.timeRequired;
+    if (order == QUEUE_SIZE_INTERVAL) {
+        key /= width;
+    }
+    if (key < 0) {
+        key = 0;
+    }
+    if (key >= (int)buckets.size()) {
+        key = (int)buckets.size() - 1;
+    }
+    return key;
+}
+
+// slots cover cycles swept+1 .. swept+size; double the ring until due fits, re-placing every entry
+void RequestQueue::indexDeadline(int key, long long seq, int due) {
+    // already due (e.g. stolen from another shard): expire on the next removeExpired()
+    if (due <= swept) {
+        due = swept + 1;
+    }
+    if (due - swept > (int)deadlines.size()) {
+        int size = deadlines.empty() ? 64 : (int)deadlines.size();
+        while (size < due - swept) {
+            size *= 2;
+        }
+        std::vector<std::vector<Deadline> > grown(size);
+        for (int i = 0; i < (int)deadlines.size(); i++) {
+            for (int j = 0; j < (int)deadlines[i].size(); j++) {
+                grown[deadlines[i][j].due & (size - 1)].push_back(deadlines[i][j]);
+            }
+        }
+        deadlines.swap(grown);
+    }
+
+    Deadline entry;
+    entry.key = key;
+    entry.seq = seq;
+    entry.due = due;
+    deadlines[due & ((int)deadlines.size() - 1)].push_back(entry);
+    indexed++;
+}
+
+// tombstones never stay at the head, so front() is always a live request
+void RequestQueue::popBucket(int key) {
+    std::deque<Entry>& bucket = buckets[key];
+    bucket.pop_front();
+    headSeq[key]++;
+    while (!bucket.empty() && !bucket.front().live) {
+        bucket.pop_front();
+        headSeq[key]++;
+    }
+}
+
+// scan the bitmap a word at a time for the next non-empty bucket
+int RequestQueue::nextOccupied(int start) const {
+    int word = start / 64;
+    if (word >= (int)occupied.size()) {
+        return -1;
+    }
+
+    unsigned long long bits = occupied[word] & (~0ULL << (start % 64));
+    while (true) {
+        if (bits != 0) {
+            return word * 64 + __builtin_ctzll(bits);
+        }
+        word++;
+        if (word >= (int)occupied.size()) {
+            return -1;
+        }
+        bits = occupied[word];
+    }
+}
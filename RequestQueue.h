@@ -0,0 +1,145 @@
+/**
+ * @file RequestQueue.h
+ * @brief Defines the RequestQueue class, the pending-request queue of a
+ *        Shard, with selectable FIFO or size-based service order.
+ *
+ * @author Karan Bhagat
+ * @date 2026
+ */
+
+#ifndef REQUESTQUEUE_H
+#define REQUESTQUEUE_H
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "Request.h"
+
+/**
+ * @enum QueueDiscipline
+ * @brief Order in which queued requests are handed to servers.
+ */
+enum QueueDiscipline {
+    QUEUE_FIFO,          ///< Arrival order.
+    QUEUE_SJF,           ///< Shortest timeRequired first, FIFO among equals.
+    QUEUE_SRPT,          ///< Like SJF, and running work may be preempted by shorter queued work.
+    QUEUE_SIZE_INTERVAL  ///< Requests grouped into size intervals; shortest interval first, FIFO within one.
+};
+
+/**
+ * @class RequestQueue
+ * @brief Bucketed priority queue keyed on bounded integer service times.
+ *
+ * Every request maps to an integer key in [0, maxKey] (0 for FIFO,
+ * timeRequired for SJF/SRPT, timeRequired / intervalWidth for the
+ * size-interval hybrid) and is appended to that key's FIFO bucket. A
+ * bitmap of non-empty buckets plus a cached lowest index makes push O(1)
+ * and pop O(1) amortized: when the lowest bucket empties, the next one is
+ * found with a count-trailing-zeros scan over 64 buckets per word.
+ *
+ * Requests with a timeout are also indexed by deadline in a ring of
+ * per-cycle slots, each entry naming the request by bucket and position.
+ * removeExpired() visits only the slots that have come due; an expired
+ * request that is not at its bucket's head is left in place as a
+ * tombstone and skipped when the head reaches it, so expiry costs O(1)
+ * per indexed request wherever it sits in the queue.
+ */
+class RequestQueue {
+public:
+    /**
+     * @brief Constructs an empty queue.
+     * @param discipline    Service order.
+     * @param maxTime       Largest timeRequired expected; larger values share the top bucket.
+     * @param intervalWidth Cycles per size interval for QUEUE_SIZE_INTERVAL (minimum 1).
+     */
+    RequestQueue(QueueDiscipline discipline = QUEUE_FIFO, int maxTime = 0, int intervalWidth = 1);
+
+    /**
+     * @brief Adds a request behind every queued request with the same key.
+     * @param request Request to enqueue.
+     */
+    void push(const Request& request);
+
+    /**
+     * @brief Returns the request that would be served next.
+     * @return Reference valid until the next push() or pop(); queue must not be empty.
+     */
+    const Request& front() const;
+
+    /** @brief Removes the request returned by front(). */
+    void pop();
+
+    /**
+     * @brief Removes every queued request whose timeout has run out by @p cycle.
+     *
+     * A request that has never started expires once @c cycle - enqueueTime
+     * reaches its timeout; a resumed (preempted) one never does.
+     *
+     * Visits the deadline slots from the last call up to @p cycle, so the
+     * cost is the requests that came due since then (including ones
+     * already dispatched, which are skipped), not size(); the others keep
+     * their order. Call once per cycle with a non-decreasing @p cycle.
+     *
+     * @param cycle   Current simulation cycle.
+     * @param expired Removed requests are appended here.
+     * @return Number of requests removed.
+     */
+    int removeExpired(int cycle, std::vector<Request>& expired);
+
+    /** @brief @c true when no requests are queued. */
+    bool empty() const;
+
+    /** @brief Number of queued requests. */
+    int size() const;
+
+    /** @brief Discipline chosen at construction time. */
+    QueueDiscipline discipline() const;
+
+    /**
+     * @brief Parses a discipline name from the config file.
+     * @param name       One of @c fifo, @c sjf, @c srpt, @c size_interval.
+     * @param discipline Output parameter set on success.
+     * @return @c true if @p name was recognised.
+     */
+    static bool parseDiscipline(const std::string& name, QueueDiscipline& discipline);
+
+private:
+    /** @brief A queued request, or a tombstone once it expired behind its bucket's head. */
+    struct Entry {
+        Request request; ///< The request (moved out once expired).
+        bool live;       ///< @c false for a tombstone.
+    };
+
+    /** @brief Deadline index entry: where a request with a timeout was queued. */
+    struct Deadline {
+        int key;         ///< Bucket it was pushed to.
+        long long seq;   ///< Its position in that bucket's push order.
+        int due;         ///< Cycle whose slot holds this entry.
+    };
+
+    QueueDiscipline order;                    ///< Service order.
+    int width;                                ///< Interval width for QUEUE_SIZE_INTERVAL.
+    std::vector<std::deque<Entry> > buckets;  ///< One FIFO per key; the head is never a tombstone.
+    std::vector<long long> headSeq;           ///< Push-order position of each bucket's head.
+    std::vector<unsigned long long> occupied; ///< Bit k set when buckets[k] holds a live request.
+    int lowest;                               ///< Lowest non-empty bucket (valid when count > 0).
+    int count;                                ///< Total queued requests (tombstones excluded).
+    std::vector<std::vector<Deadline> > deadlines; ///< Ring of per-cycle slots, power-of-two size.
+    int swept;                                ///< Last cycle passed to removeExpired().
+    int indexed;                              ///< Entries in @c deadlines, stale ones included.
+
+    /** @brief Maps a request to its bucket index. */
+    int keyFor(const Request& request) const;
+
+    /** @brief Adds a deadline entry, growing the ring if @p due is past its end. */
+    void indexDeadline(int key, long long seq, int due);
+
+    /** @brief Drops the head of bucket @p key and any tombstones behind it. */
+    void popBucket(int key);
+
+    /** @brief Finds the first non-empty bucket at or after @p start, or -1. */
+    int nextOccupied(int start) const;
+};
+
+#endif
@@ -0,0 +1,219 @@
+// ResponseCache.cpp
+
+#include "ResponseCache.h"
+
+// rows in the TinyLFU count-min sketch
+const int SKETCH_ROWS = 4;
+// 4-bit counters: frequencies saturate here
+const int SKETCH_MAX = 15;
+// halve the sketch after this many accesses per cached key
+const int SKETCH_RESET_FACTOR = 10;
+
+// splitmix64 finaliser, so sequential keys spread over the table
+static unsigned long long mix(unsigned long long key) {
+    key ^= key >> 30;
+    key *= 0xBF58476D1CE4E5B9ULL;
+    key ^= key >> 27;
+    key *= 0x94D049BB133111EBULL;
+    key ^= key >> 31;
+    return key;
+}
+
+// smallest power of two >= n
+static int powerOfTwo(int n) {
+    int size = 1;
+    while (size < n) {
+        size *= 2;
+    }
+    return size;
+}
+
+// empty cache with all storage allocated up front
+ResponseCache::ResponseCache(CachePolicy policy, int capacity) {
+    admission = policy;
+    limit = capacity < 1 ? 1 : capacity;
+    count = 0;
+    keys.assign(limit, 0);
+    prev.assign(limit, -1);
+    next.assign(limit, -1);
+    head = -1;
+    tail = -1;
+    slots.assign(powerOfTwo(limit * 2), -1);
+    mask = slots.size() - 1;
+    sketchMask = 0;
+    if (admission == CACHE_TINYLFU) {
+        int width = powerOfTwo(limit * 2);
+        sketch.assign(SKETCH_ROWS * width, 0);
+        sketchMask = width - 1;
+    }
+    samples = 0;
+    hitCount = 0;
+    lookupCount = 0;
+}
+
+// hit: move to front; miss: insert, evicting the LRU key if TinyLFU lets it in
+bool ResponseCache::access(unsigned long long key) {
+    lookupCount++;
+    if (admission == CACHE_TINYLFU) {
+        recordFrequency(key);
+    }
+
+    int slot = findSlot(key);
+    if (slot >= 0) {
+        int entry = slots[slot];
+        if (entry != head) {
+            unlink(entry);
+            pushFront(entry);
+        }
+        hitCount++;
+        return true;
+    }
+
+    int entry = count;
+    if (count == limit) {
+        if (admission == CACHE_TINYLFU && estimateFrequency(key) <= estimateFrequency(keys[tail])) {
+            return false;
+        }
+        entry = tail;
+        indexErase(findSlot(keys[entry]));
+        unlink(entry);
+    } else {
+        count++;
+    }
+    keys[entry] = key;
+    indexInsert(entry);
+    pushFront(entry);
+    return false;
+}
+
+// getter for the hit counter
+long long ResponseCache::hits() const {
+    return hitCount;
+}
+
+// getter for the lookup counter
+long long ResponseCache::lookups() const {
+    return lookupCount;
+}
+
+// getter for the number of keys held
+int ResponseCache::size() const {
+    return count;
+}
+
+// config name -> policy
+bool ResponseCache::parsePolicy(const std::string& name, CachePolicy& policy) {
+    if (name == "none") {
+        policy = CACHE_NONE;
+    } else if (name == "lru") {
+        policy = CACHE_LRU;
+    } else if (name == "tinylfu") {
+        policy = CACHE_TINYLFU;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// linear probe from the key's home slot until the key or an empty slot
+int ResponseCache::findSlot(unsigned long long key) const {
+    unsigned long long slot = mix(key) & mask;
+    while (slots[slot] >= 0) {
+        if (keys[slots[slot]] == key) {
+            return (int)slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return -1;
+}
+
+// first empty slot along the probe sequence
+void ResponseCache::indexInsert(int entry) {
+    unsigned long long slot = mix(keys[entry]) & mask;
+    while (slots[slot] >= 0) {
+        slot = (slot + 1) & mask;
+    }
+    slots[slot] = entry;
+}
+
+// backward-shift deletion: pull later entries of the probe run into the hole
+void ResponseCache::indexErase(int slot) {
+    unsigned long long hole = slot;
+    unsigned long long probe = hole;
+    slots[hole] = -1;
+    while (true) {
+        probe = (probe + 1) & mask;
+        if (slots[probe] < 0) {
+            return;
+        }
+        unsigned long long home = mix(keys[slots[probe]]) & mask;
+        // an entry whose home lies cyclically in (hole, probe] is still reachable; leave it
+        bool reachable = hole <= probe ? (home > hole && home <= probe) : (home > hole || home <= probe);
+        if (!reachable) {
+            slots[hole] = slots[probe];
+            slots[probe] = -1;
+            hole = probe;
+        }
+    }
+}
+
+// take an entry out of the LRU list
+void ResponseCache::unlink(int entry) {
+    if (prev[entry] >= 0) {
+        next[prev[entry]] = next[entry];
+    } else {
+        head = next[entry];
+    }
+    if (next[entry] >= 0) {
+        prev[next[entry]] = prev[entry];
+    } else {
+        tail = prev[entry];
+    }
+    prev[entry] = -1;
+    next[entry] = -1;
+}
+
+// make an entry the most recently used
+void ResponseCache::pushFront(int entry) {
+    prev[entry] = -1;
+    next[entry] = head;
+    if (head >= 0) {
+        prev[head] = entry;
+    }
+    head = entry;
+    if (tail < 0) {
+        tail = entry;
+    }
+}
+
+// bump one counter per row; halve everything once the sample window is full
+void ResponseCache::recordFrequency(unsigned long long key) {
+    unsigned long long hash = mix(key);
+    for (int row = 0; row < SKETCH_ROWS; row++) {
+        unsigned char& counter = sketch[row * (sketchMask + 1) + ((hash >> (row * 16)) & sketchMask)];
+        if (counter < SKETCH_MAX) {
+            counter++;
+        }
+    }
+
+    samples++;
+    if (samples >= (long long)SKETCH_RESET_FACTOR * limit) {
+        for (int i = 0; i < (int)sketch.size(); i++) {
+            sketch[i] /= 2;
+        }
+        samples /= 2;
+    }
+}
+
+// smallest of the key's counters
+int ResponseCache::estimateFrequency(unsigned long long key) const {
+    unsigned long long hash = mix(key);
+    int estimate = SKETCH_MAX;
+    for (int row = 0; row < SKETCH_ROWS; row++) {
+        int counter = sketch[row * (sketchMask + 1) + ((hash >> (row * 16)) & sketchMask)];
+        if (counter < estimate) {
+            estimate = counter;
+        }
+    }
+    return estimate;
+}
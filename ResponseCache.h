@@ -0,0 +1,119 @@
+/**
+ * @file ResponseCache.h
+ * @brief Defines the bounded per-server response cache and its eviction and
+ *        admission policies.
+ *
+ * @author Karan Bhagat
+ * @date 2026
+ */
+
+#ifndef RESPONSECACHE_H
+#define RESPONSECACHE_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @enum CachePolicy
+ * @brief Which keys a ResponseCache keeps once it is full.
+ */
+enum CachePolicy {
+    CACHE_NONE,   ///< No cache.
+    CACHE_LRU,    ///< Evict the least recently used key on every miss.
+    CACHE_TINYLFU ///< LRU eviction, but a missed key only replaces the LRU victim if it is estimated to be more frequent.
+};
+
+/**
+ * @class ResponseCache
+ * @brief Fixed-capacity cache of response keys for one WebServer.
+ *
+ * Only keys are stored, since the simulation only needs to know whether a
+ * request would hit. Entries live in preallocated arrays linked into an
+ * LRU list by index, and are found through an open-addressed (linear
+ * probing) table of entry indices at most half full; removals use
+ * backward-shift deletion, so there are no tombstones and nothing is
+ * allocated after construction.
+ *
+ * With CACHE_TINYLFU every access is also counted in a 4-row count-min
+ * sketch of 4-bit counters, halved after 10 × capacity accesses so old
+ * popularity fades. On a miss with the cache full, the new key is admitted
+ * only if its estimated frequency exceeds the LRU victim's, which keeps
+ * one-off keys from flushing popular ones.
+ */
+class ResponseCache {
+public:
+    /**
+     * @param policy   CACHE_LRU or CACHE_TINYLFU.
+     * @param capacity Maximum number of keys held (minimum 1).
+     */
+    ResponseCache(CachePolicy policy, int capacity);
+
+    /**
+     * @brief Looks a key up and records the access.
+     *
+     * A hit moves the key to the front of the LRU list. A miss inserts it,
+     * evicting the least recently used key if the cache is full (subject
+     * to TinyLFU admission).
+     *
+     * @param key Cache key (e.g. a content id or a hash of Request::ipOut).
+     * @return @c true on a hit.
+     */
+    bool access(unsigned long long key);
+
+    /** @brief Accesses that hit. */
+    long long hits() const;
+
+    /** @brief Accesses in total. */
+    long long lookups() const;
+
+    /** @brief Keys currently held. */
+    int size() const;
+
+    /**
+     * @brief Parses a cache policy name from the config file.
+     * @param name   One of @c none, @c lru, @c tinylfu.
+     * @param policy Output parameter set on success.
+     * @return @c true if @p name was recognised.
+     */
+    static bool parsePolicy(const std::string& name, CachePolicy& policy);
+
+private:
+    CachePolicy admission;              ///< Eviction/admission policy.
+    int limit;                          ///< Capacity in keys.
+    int count;                          ///< Keys held.
+    std::vector<unsigned long long> keys; ///< Key of each entry.
+    std::vector<int> prev;              ///< LRU list: entry towards the front, or -1.
+    std::vector<int> next;              ///< LRU list: entry towards the back, or -1.
+    int head;                           ///< Most recently used entry, or -1.
+    int tail;                           ///< Least recently used entry, or -1.
+    std::vector<int> slots;             ///< Open-addressed index: entry number, or -1 for empty.
+    unsigned long long mask;            ///< slots.size() - 1 (a power of two).
+    std::vector<unsigned char> sketch;  ///< Count-min counters, 4 rows of sketchWidth.
+    unsigned long long sketchMask;      ///< sketchWidth - 1.
+    long long samples;                  ///< Accesses counted since the last halving.
+    long long hitCount;                 ///< Hits so far.
+    long long lookupCount;              ///< Lookups so far.
+
+    /** @brief Index slot holding @p key, or -1. */
+    int findSlot(unsigned long long key) const;
+
+    /** @brief Adds entry @p entry (whose key is set) to the index. */
+    void indexInsert(int entry);
+
+    /** @brief Removes the index slot @p slot, shifting later probes back. */
+    void indexErase(int slot);
+
+    /** @brief Unlinks an entry from the LRU list. */
+    void unlink(int entry);
+
+    /** @brief Links an entry at the front of the LRU list. */
+    void pushFront(int entry);
+
+    /** @brief Counts one access of @p key in the sketch. */
+    void recordFrequency(unsigned long long key);
+
+    /** @brief Count-min estimate of how often @p key was accessed recently. */
+    int estimateFrequency(unsigned long long key) const;
+};
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * @file RingBuffer.h
+ * @brief Defines the SpscRing class template, a bounded lock-free queue for
+ *        passing items from exactly one producer thread to one consumer.
+ *
+ * @author Karan Bhagat
+ * @date 2026
+ */
+
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @class SpscRing
+ * @brief Fixed-capacity single-producer/single-consumer ring buffer.
+ *
+ * The producer only writes @c tail and the consumer only writes @c head, so
+ * no locks or compare-and-swap loops are needed; each side publishes its
+ * progress with a release store and observes the other with an acquire load.
+ * Capacity is rounded up to a power of two so slot lookup is a mask. Both
+ * operations are non-blocking: callers decide how to wait (spin, yield,
+ * drop) when the ring is full or empty, which is how back-pressure is
+ * applied between pipeline stages.
+ *
+ * @tparam T Element type; must be default-constructible and movable.
+ */
+template <typename T>
+class SpscRing {
+public:
+    /**
+     * @brief Allocates all slots up front.
+     * @param capacity Requested number of slots (rounded up to a power of two, minimum 2).
+     */
+    explicit SpscRing(int capacity) : head(0), tail(0) {
+        size_t size = 2;
+        while (size < (size_t)capacity) {
+            size <<= 1;
+        }
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    /**
+     * @brief Producer side: moves @p item into the ring if there is room.
+     * @param item Item to enqueue; left moved-from on success.
+     * @return @c true if the item was enqueued; @c false if the ring is full.
+     */
+    bool tryPush(T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) > mask) {
+            return false;
+        }
+        slots[t & mask] = std::move(item);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Consumer side: moves the oldest item out of the ring.
+     * @param item Output parameter filled with the dequeued item.
+     * @return @c true if an item was dequeued; @c false if the ring is empty.
+     */
+    bool tryPop(T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = std::move(slots[h & mask]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Returns the number of slots in the ring.
+     * @return Power-of-two capacity chosen at construction time.
+     */
+    int capacity() const {
+        return (int)(mask + 1);
+    }
+
+private:
+    std::vector<T> slots;                 ///< Storage for queued items.
+    size_t mask;                          ///< capacity - 1, used to wrap indices.
+    alignas(64) std::atomic<size_t> head; ///< Next slot to read (written by the consumer).
+    alignas(64) std::atomic<size_t> tail; ///< Next slot to write (written by the producer).
+};
+
+#endif
@@ -0,0 +1,358 @@
+// ScalingPolicy.cpp
+
+#include "ScalingPolicy.h"
+#include <algorithm>
+#include <cmath>
+
+// a scale-down needs this much slack so the pool does not flap around the target
+const double SCALE_DOWN_MARGIN = 0.9;
+// largest relative wait error the PID controller acts on, so one huge p95 cannot flood the pool
+const double PID_ERROR_CAP = 4.0;
+
+// latency samples are ignored by default
+void ScalingPolicy::recordWait(int) {
+}
+
+// no policy-specific status by default
+void ScalingPolicy::status(LogBuffer&) const {
+}
+
+// name -> new policy, nullptr if unknown
+ScalingPolicy* ScalingPolicy::create(const Config& config) {
+    if (config.scalingPolicy == "threshold") {
+        return new ThresholdScaling(config.scalingCooldownCycles);
+    }
+    if (config.scalingPolicy == "step") {
+        return new StepScaling(config.scalingCooldownCycles, config.scaleMaxStep);
+    }
+    if (config.scalingPolicy == "predictive") {
+        return new PredictiveScaling(config.scalingCooldownCycles, config.scalingHorizon, config.targetUtilization, config.forecastAlpha);
+    }
+    if (config.scalingPolicy == "pid") {
+        return new PidScaling(config.scalingCooldownCycles, config.sloWaitP95, config.pidKp, config.pidKi, config.pidKd, config.pidMaxStep);
+    }
+    return nullptr;
+}
+
+// true if create() knows the name
+bool ScalingPolicy::isKnown(const std::string& name) {
+    return name == "threshold" || name == "step" || name == "predictive" || name == "pid";
+}
+
+// threshold policy starts with no cooldown
+ThresholdScaling::ThresholdScaling(int cooldownCycles) {
+    cooldown = cooldownCycles;
+    cooldownTimer = 0;
+    lastQueued = 0;
+    lastThreshold = 0;
+    lastDelta = 0;
+}
+
+// getter for the config name
+std::string ThresholdScaling::name() const {
+    return "threshold";
+}
+
+// one server up or down when the queue leaves the threshold band
+ScalingDecision ThresholdScaling::decide(const ScalingSnapshot& snapshot) {
+    ScalingDecision decision;
+    if (cooldownTimer > 0) {
+        cooldownTimer--;
+        return decision;
+    }
+
+    int lowerThreshold = (int)(MIN_QUEUE_PER_SERVER * snapshot.capacity);
+    int upperThreshold = (int)(MAX_QUEUE_PER_SERVER * snapshot.capacity);
+    if (snapshot.queued > upperThreshold) {
+        decision.delta = 1;
+        decision.neededCapacity = (double)(snapshot.queued - upperThreshold) / MAX_QUEUE_PER_SERVER;
+        lastThreshold = upperThreshold;
+    } else if (snapshot.queued < lowerThreshold && snapshot.servers > 1) {
+        decision.delta = -1;
+        lastThreshold = lowerThreshold;
+    }
+    lastQueued = snapshot.queued;
+    lastDelta = decision.delta;
+    return decision;
+}
+
+// start the cooldown after any change that took effect
+void ThresholdScaling::onScaled(int applied) {
+    if (applied != 0) {
+        cooldownTimer = cooldown;
+    }
+}
+
+// which threshold the queue crossed
+void ThresholdScaling::reason(LogBuffer& out) const {
+    out << "queue=" << lastQueued << (lastDelta > 0 ? " exceeded max threshold=" : " below min threshold=") << lastThreshold;
+}
+
+// step policy starts with no cooldown
+StepScaling::StepScaling(int cooldownCycles, int maxStep) {
+    cooldown = cooldownCycles;
+    cooldownTimer = 0;
+    stepLimit = maxStep < 1 ? 1 : maxStep;
+    lastQueued = 0;
+    lastThreshold = 0;
+    lastGap = 0;
+    lastDelta = 0;
+}
+
+// getter for the config name
+std::string StepScaling::name() const {
+    return "step";
+}
+
+// as many servers as the distance outside the threshold band is worth
+ScalingDecision StepScaling::decide(const ScalingSnapshot& snapshot) {
+    ScalingDecision decision;
+    if (cooldownTimer > 0) {
+        cooldownTimer--;
+        return decision;
+    }
+
+    double perServer = snapshot.servers > 0 ? snapshot.capacity / snapshot.servers : 1.0;
+    int lowerThreshold = (int)(MIN_QUEUE_PER_SERVER * snapshot.capacity);
+    int upperThreshold = (int)(MAX_QUEUE_PER_SERVER * snapshot.capacity);
+    if (snapshot.queued > upperThreshold) {
+        int excess = snapshot.queued - upperThreshold;
+        int step = (int)std::ceil(excess / (MAX_QUEUE_PER_SERVER * perServer));
+        decision.delta = std::min(std::max(step, 1), stepLimit);
+        decision.neededCapacity = (double)excess / MAX_QUEUE_PER_SERVER;
+        lastThreshold = upperThreshold;
+        lastGap = excess;
+    } else if (snapshot.queued < lowerThreshold && snapshot.servers > 1) {
+        int shortfall = lowerThreshold - snapshot.queued;
+        int step = (int)(shortfall / (MIN_QUEUE_PER_SERVER * perServer));
+        decision.delta = -std::min(std::max(step, 1), stepLimit);
+        lastThreshold = lowerThreshold;
+        lastGap = shortfall;
+    }
+    lastQueued = snapshot.queued;
+    lastDelta = decision.delta;
+    return decision;
+}
+
+// start the cooldown after any change that took effect
+void StepScaling::onScaled(int applied) {
+    if (applied != 0) {
+        cooldownTimer = cooldown;
+    }
+}
+
+// which threshold the queue crossed, and by how much
+void StepScaling::reason(LogBuffer& out) const {
+    out << "queue=" << lastQueued << (lastDelta > 0 ? " exceeded max threshold=" : " below min threshold=") << lastThreshold << " by " << lastGap;
+}
+
+// predictive policy with no history yet
+PredictiveScaling::PredictiveScaling(int cooldownCycles, int horizon, double targetUtilization, double alpha) {
+    cooldown = cooldownCycles;
+    cooldownTimer = 0;
+    horizonCycles = horizon < 1 ? 1 : horizon;
+    utilization = targetUtilization;
+    weight = alpha;
+    level = 0.0;
+    trend = 0.0;
+    workPerRequest = 0.0;
+    primed = false;
+    forecast = 0.0;
+    target = 0;
+    lastQueued = 0;
+    needed = 0.0;
+}
+
+// getter for the config name
+std::string PredictiveScaling::name() const {
+    return "predictive";
+}
+
+// update the forecast every cycle, resize the pool when the cooldown allows
+ScalingDecision PredictiveScaling::decide(const ScalingSnapshot& snapshot) {
+    ScalingDecision decision;
+    // Holt smoothing; the trend gets a quarter of the weight so one busy cycle does not swing it
+    if (!primed) {
+        level = snapshot.arrivals;
+        trend = 0.0;
+    } else {
+        double previous = level;
+        level = weight * snapshot.arrivals + (1.0 - weight) * (level + trend);
+        trend = weight / 4 * (level - previous) + (1.0 - weight / 4) * trend;
+    }
+    if (!primed) {
+        workPerRequest = snapshot.meanWork;
+    }
+    if (snapshot.arrivals > 0) {
+        double batchWork = (double)snapshot.arrivalWork / snapshot.arrivals;
+        workPerRequest = workPerRequest > 0.0 ? weight * batchWork + (1.0 - weight) * workPerRequest : batchWork;
+    }
+    primed = true;
+
+    forecast = level + trend * horizonCycles;
+    if (forecast < 0.0) {
+        forecast = 0.0;
+    }
+    lastQueued = snapshot.queued;
+    needed = (forecast * workPerRequest + snapshot.queued * workPerRequest / horizonCycles) / utilization;
+    double perServer = snapshot.servers > 0 ? snapshot.capacity / snapshot.servers : 1.0;
+    target = (int)std::ceil(needed / perServer);
+    if (target < 1) {
+        target = 1;
+    }
+
+    if (cooldownTimer > 0) {
+        cooldownTimer--;
+        return decision;
+    }
+
+    int shrinkTo = (int)std::ceil(needed / (perServer * SCALE_DOWN_MARGIN));
+    if (shrinkTo < 1) {
+        shrinkTo = 1;
+    }
+    if (target > snapshot.servers) {
+        decision.delta = target - snapshot.servers;
+        decision.neededCapacity = needed - snapshot.capacity;
+    } else if (shrinkTo < snapshot.servers) {
+        decision.delta = shrinkTo - snapshot.servers;
+    }
+    return decision;
+}
+
+// start the cooldown after any change that took effect
+void PredictiveScaling::onScaled(int applied) {
+    if (applied != 0) {
+        cooldownTimer = cooldown;
+    }
+}
+
+// forecast demand that sized the pool
+void PredictiveScaling::reason(LogBuffer& out) const {
+    out << "forecast=";
+    out.fixed(forecast, 2) << " req/cycle x ";
+    out.fixed(workPerRequest, 2) << " work, queue=" << lastQueued << " needs capacity ";
+    out.fixed(needed, 2);
+}
+
+// forecast and target for the status line
+void PredictiveScaling::status(LogBuffer& out) const {
+    out << "forecast=";
+    out.fixed(forecast, 2) << "/cycle target=" << target;
+}
+
+// controller waits one full interval before its first step
+PidScaling::PidScaling(int interval, int targetWait, double kp, double ki, double kd, int maxStep) {
+    period = interval < 1 ? 1 : interval;
+    cyclesLeft = period;
+    target = targetWait < 1 ? 1 : targetWait;
+    gainP = kp;
+    gainI = ki;
+    gainD = kd;
+    stepLimit = maxStep < 1 ? 1 : maxStep;
+    started = false;
+    integral = 0.0;
+    lastError = 0.0;
+    error = 0.0;
+    proportional = 0.0;
+    derivative = 0.0;
+    measured = 0;
+    commanded = 0;
+}
+
+// getter for the config name
+std::string PidScaling::name() const {
+    return "pid";
+}
+
+// collect waits for the next step's p95
+void PidScaling::recordWait(int wait) {
+    waits.push_back(wait);
+}
+
+// one PID step per interval on the p95 of the waits seen since the last one
+ScalingDecision PidScaling::decide(const ScalingSnapshot& snapshot) {
+    ScalingDecision decision;
+    cyclesLeft--;
+    if (cyclesLeft > 0) {
+        return decision;
+    }
+    cyclesLeft = period;
+
+    // bumpless start: the integral alone reproduces the current pool
+    if (!started) {
+        integral = snapshot.servers;
+        started = true;
+    }
+
+    // nothing dispatched: keep the last reading while work is stuck, else nothing is waiting
+    if (!waits.empty()) {
+        int rank = (int)(waits.size() * 0.95);
+        if (rank >= (int)waits.size()) {
+            rank = (int)waits.size() - 1;
+        }
+        std::nth_element(waits.begin(), waits.begin() + rank, waits.end());
+        measured = waits[rank];
+        waits.clear();
+    } else if (snapshot.queued == 0) {
+        measured = 0;
+    }
+
+    error = (double)(measured - target) / target;
+    if (error > PID_ERROR_CAP) {
+        error = PID_ERROR_CAP;
+    }
+    // gains are fractions of the current pool, so the same tuning works at any scale
+    proportional = gainP * error * snapshot.servers;
+    derivative = gainD * (error - lastError) * snapshot.servers;
+    lastError = error;
+
+    double nextIntegral = integral + gainI * error * snapshot.servers;
+    int desired = (int)std::lround(proportional + nextIntegral + derivative);
+    bool saturatedLow = desired < 1;
+    if (saturatedLow) {
+        desired = 1;
+    }
+    int delta = desired - snapshot.servers;
+    bool saturatedHigh = delta > stepLimit;
+    if (saturatedHigh) {
+        delta = stepLimit;
+    }
+    if (delta < -stepLimit) {
+        delta = -stepLimit;
+        saturatedLow = true;
+    }
+    // conditional integration: never wind further into a limit, or up while servers are still booting
+    bool booting = snapshot.pendingServers > 0 && error > 0.0;
+    if (!booting && (!saturatedHigh || error < 0.0) && (!saturatedLow || error > 0.0)) {
+        integral = nextIntegral;
+    }
+
+    commanded = delta;
+    if (delta == 0) {
+        return decision;
+    }
+    decision.delta = delta;
+    decision.neededCapacity = snapshot.servers > 0 ? delta * snapshot.capacity / snapshot.servers : delta;
+    return decision;
+}
+
+// take back the part of the command the balancer could not carry out
+void PidScaling::onScaled(int applied) {
+    integral -= commanded - applied;
+}
+
+// measured wait against the SLO, with the controller terms
+void PidScaling::reason(LogBuffer& out) const {
+    out << "p95 wait=" << measured << " target=" << target << " (";
+    status(out);
+    out << ')';
+}
+
+// controller terms for tuning
+void PidScaling::status(LogBuffer& out) const {
+    out << "p95=" << measured << " err=";
+    out.fixed(error, 2) << " P=";
+    out.fixed(proportional, 2) << " I=";
+    out.fixed(integral, 2) << " D=";
+    out.fixed(derivative, 2);
+}
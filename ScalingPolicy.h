@@ -0,0 +1,304 @@
+/**
+ * @file ScalingPolicy.h
+ * @brief Defines the ScalingPolicy interface and the built-in autoscalers
+ *        that decide how many servers to add or remove each cycle.
+ *
+ * @author Karan Bhagat
+ * @date 2026
+ */
+
+#ifndef SCALINGPOLICY_H
+#define SCALINGPOLICY_H
+
+#include <string>
+#include <vector>
+
+#include "Config.h"
+#include "LogBuffer.h"
+
+/// Scale-down threshold, in queued requests per unit of service capacity.
+const int MIN_QUEUE_PER_SERVER = 50;
+/// Scale-up threshold, in queued requests per unit of service capacity.
+const int MAX_QUEUE_PER_SERVER = 80;
+
+/**
+ * @struct ScalingSnapshot
+ * @brief What the load balancer measured this cycle, handed to the policy.
+ *
+ * Capacity is in units of one speed-1 slot (WebServer::serviceRate()), which
+ * is also one unit of work (a cycle of Request::timeRequired) per cycle.
+ * Servers that are still booting count towards @c servers and @c capacity,
+ * so a policy does not ask again for capacity that is already on its way.
+ */
+struct ScalingSnapshot {
+    int cycle;             ///< Current simulation cycle.
+    int queued;            ///< Requests queued across all shards.
+    int servers;           ///< Servers in the pool, including those still provisioning.
+    double capacity;       ///< Service capacity of the pool, including servers still provisioning.
+    int pendingServers;    ///< Servers added but still provisioning (no work accepted yet).
+    double pendingCapacity; ///< Service capacity of those servers.
+    int arrivals;          ///< Requests admitted to the queue this cycle.
+    long long arrivalWork; ///< Sum of timeRequired over this cycle's admitted requests.
+    int completed;         ///< Requests completed this cycle.
+    double meanWork;       ///< Mean timeRequired of every request admitted so far, initial fill included.
+
+    ScalingSnapshot() {
+        cycle = 0;
+        queued = 0;
+        servers = 0;
+        capacity = 0.0;
+        pendingServers = 0;
+        pendingCapacity = 0.0;
+        arrivals = 0;
+        arrivalWork = 0;
+        completed = 0;
+        meanWork = 0.0;
+    }
+};
+
+/**
+ * @struct ScalingDecision
+ * @brief A policy's answer for one cycle.
+ */
+struct ScalingDecision {
+    int delta;             ///< Servers to add (> 0) or remove (< 0); 0 = leave the pool alone.
+    double neededCapacity; ///< Capacity the policy wants added, used to pick server types.
+
+    ScalingDecision() {
+        delta = 0;
+        neededCapacity = 0.0;
+    }
+};
+
+/**
+ * @class ScalingPolicy
+ * @brief Decides each cycle whether the server pool should grow or shrink.
+ *
+ * The LoadBalancer calls decide() once per cycle with fresh measurements,
+ * carries out the decision as far as it can (scale-down only removes idle
+ * servers), logs it with reason() and reports what actually happened
+ * through onScaled(), which is where policies start their cooldown.
+ */
+class ScalingPolicy {
+public:
+    virtual ~ScalingPolicy() {}
+
+    /** @brief Config name of the policy (e.g. @c "threshold"). */
+    virtual std::string name() const = 0;
+
+    /**
+     * @brief Looks at this cycle's measurements and proposes a pool change.
+     * @param snapshot Measurements for the cycle just simulated.
+     * @return The proposed change; @c delta is 0 to do nothing.
+     */
+    virtual ScalingDecision decide(const ScalingSnapshot& snapshot) = 0;
+
+    /**
+     * @brief Receives the queue wait of one dispatched request.
+     *
+     * Called for every dispatch, before decide() for the same cycle.
+     * Policies that do not control on latency ignore it.
+     *
+     * @param wait Cycles the request spent queued.
+     */
+    virtual void recordWait(int wait);
+
+    /**
+     * @brief Reports how many servers were actually added or removed.
+     * @param applied Servers added (> 0) or removed (< 0); may be smaller than proposed.
+     */
+    virtual void onScaled(int applied) = 0;
+
+    /**
+     * @brief Appends why the last decide() proposed a change, for the scale event line.
+     * @param out Buffer to append text such as "queue=900 exceeded max threshold=800" to.
+     */
+    virtual void reason(LogBuffer& out) const = 0;
+
+    /**
+     * @brief Appends policy-specific state for the periodic status line.
+     * @param out Buffer to append short text such as "forecast=0.52/cycle"
+     *            to; left untouched if the policy has none.
+     */
+    virtual void status(LogBuffer& out) const;
+
+    /**
+     * @brief Creates a policy by its config name (Config::scalingPolicy).
+     *
+     * Known names: @c threshold, @c step, @c predictive and @c pid.
+     *
+     * @param config Simulation settings.
+     * @return A new heap-allocated policy, or @c nullptr for an unknown name.
+     */
+    static ScalingPolicy* create(const Config& config);
+
+    /**
+     * @brief Checks whether create() recognises a policy name.
+     * @param name Policy name from the config file.
+     * @return @c true if @p name is a built-in policy.
+     */
+    static bool isKnown(const std::string& name);
+};
+
+/**
+ * @class ThresholdScaling
+ * @brief The simulator's original rule: one server at a time when the queue
+ *        leaves the [MIN, MAX]_QUEUE_PER_SERVER × capacity band.
+ */
+class ThresholdScaling : public ScalingPolicy {
+public:
+    /** @param cooldownCycles Cycles to wait after a scale event. */
+    ThresholdScaling(int cooldownCycles);
+    std::string name() const override;
+    ScalingDecision decide(const ScalingSnapshot& snapshot) override;
+    void onScaled(int applied) override;
+    void reason(LogBuffer& out) const override;
+
+private:
+    int cooldown;      ///< Cycles to wait after a scale event.
+    int cooldownTimer; ///< Cycles left before the next decision.
+    int lastQueued;    ///< Queue length at the last proposed change, for reason().
+    int lastThreshold; ///< Threshold it crossed.
+    int lastDelta;     ///< Direction of the last proposed change.
+};
+
+/**
+ * @class StepScaling
+ * @brief Threshold band like ThresholdScaling, but each event moves the pool
+ *        by a step proportional to how far the queue is outside the band.
+ *
+ * Above the band, k = ceil((queued - upper) / (MAX_QUEUE_PER_SERVER × c))
+ * servers are added, where c is the capacity of an average server, so one
+ * event provides the capacity the excess calls for. Below the band,
+ * k = floor((lower - queued) / (MIN_QUEUE_PER_SERVER × c)) servers (at least
+ * one) are removed. Either way k is capped at @c maxStep, and the cooldown
+ * runs once per event rather than once per server.
+ */
+class StepScaling : public ScalingPolicy {
+public:
+    /**
+     * @param cooldownCycles Cycles to wait after a scale event.
+     * @param maxStep        Largest pool change per event.
+     */
+    StepScaling(int cooldownCycles, int maxStep);
+    std::string name() const override;
+    ScalingDecision decide(const ScalingSnapshot& snapshot) override;
+    void onScaled(int applied) override;
+    void reason(LogBuffer& out) const override;
+
+private:
+    int cooldown;      ///< Cycles to wait after a scale event.
+    int cooldownTimer; ///< Cycles left before the next decision.
+    int stepLimit;     ///< Largest change per event.
+    int lastQueued;    ///< Queue length at the last proposed change, for reason().
+    int lastThreshold; ///< Threshold it crossed.
+    int lastGap;       ///< Distance past the threshold.
+    int lastDelta;     ///< Direction of the last proposed change.
+};
+
+/**
+ * @class PredictiveScaling
+ * @brief Sizes the pool for forecast demand instead of reacting to queue length.
+ *
+ * Tracks the arrival rate with Holt's double exponential smoothing (level
+ * and trend) and the mean work per request with an EWMA, then forecasts
+ * the arrival rate one provisioning horizon ahead. The capacity it asks
+ * for covers that forecast plus clearing the current backlog within the
+ * horizon, divided by the target utilization:
+ *
+ *   needed = (rate(t + H) × work + queued × work / H) / utilization
+ *
+ * The pool is resized in one step to the server count that provides
+ * @c needed at the pool's current capacity per server.
+ */
+class PredictiveScaling : public ScalingPolicy {
+public:
+    /**
+     * @param cooldownCycles    Cycles to wait after a scale event.
+     * @param horizon           Provisioning horizon H, in cycles.
+     * @param targetUtilization Utilization the pool is sized for, in (0, 1].
+     * @param alpha             Smoothing weight for level, trend and work per request.
+     */
+    PredictiveScaling(int cooldownCycles, int horizon, double targetUtilization, double alpha);
+    std::string name() const override;
+    ScalingDecision decide(const ScalingSnapshot& snapshot) override;
+    void onScaled(int applied) override;
+    void reason(LogBuffer& out) const override;
+    void status(LogBuffer& out) const override;
+
+private:
+    int cooldown;        ///< Cycles to wait after a scale event.
+    int cooldownTimer;   ///< Cycles left before the next decision.
+    int horizonCycles;   ///< Provisioning horizon.
+    double utilization;  ///< Target utilization.
+    double weight;       ///< Smoothing weight.
+    double level;        ///< Smoothed arrivals per cycle.
+    double trend;        ///< Smoothed change in arrivals per cycle, per cycle.
+    double workPerRequest; ///< EWMA of timeRequired of admitted requests.
+    bool primed;         ///< Whether any arrival has been seen yet.
+    double forecast;     ///< Last forecast arrival rate, for status().
+    int target;          ///< Last target server count, for status().
+    int lastQueued;      ///< Queue length at the last decision, for reason().
+    double needed;       ///< Capacity needed at the last decision, for reason().
+};
+
+/**
+ * @class PidScaling
+ * @brief Drives the pool size so that the p95 queue wait meets an SLO.
+ *
+ * Every control interval the p95 of the waits recorded since the previous
+ * step is compared with the target. The relative error
+ * e = (p95 - target) / target, capped at PID_ERROR_CAP, feeds a PID
+ * controller whose output is the desired pool size n:
+ *
+ *   n = (Kp·e + Kd·(e - e_prev))·n_now + I,   I += Ki·e·n_now
+ *
+ * Gains are fractions of the current pool size n_now, so one tuning
+ * behaves the same on small and large pools.
+ * The integral is kept in servers and starts at the current pool size, so
+ * switching the controller on does not move the pool. Anti-windup: the
+ * integral stops accumulating in a direction the output is already
+ * saturated in (pool bounds or step limit), and whatever part of a command
+ * could not be carried out (e.g. no idle server to remove) is taken back
+ * out of it. While added servers are still provisioning the integral does
+ * not grow, since the wait they are meant to fix has not had a chance to
+ * fall yet. Each step changes the pool by at most @c maxStep servers.
+ */
+class PidScaling : public ScalingPolicy {
+public:
+    /**
+     * @param interval   Cycles between control steps.
+     * @param targetWait p95 queue wait the controller aims for, in cycles.
+     * @param kp         Proportional gain, as a fraction of the pool per unit of relative error.
+     * @param ki         Integral gain, as a fraction of the pool per unit of error per step.
+     * @param kd         Derivative gain, as a fraction of the pool per unit of error change.
+     * @param maxStep    Largest pool change per step.
+     */
+    PidScaling(int interval, int targetWait, double kp, double ki, double kd, int maxStep);
+    std::string name() const override;
+    void recordWait(int wait) override;
+    ScalingDecision decide(const ScalingSnapshot& snapshot) override;
+    void onScaled(int applied) override;
+    void reason(LogBuffer& out) const override;
+    void status(LogBuffer& out) const override;
+
+private:
+    int period;               ///< Cycles between control steps.
+    int cyclesLeft;           ///< Cycles until the next step.
+    int target;               ///< Target p95 wait.
+    double gainP;             ///< Kp.
+    double gainI;             ///< Ki.
+    double gainD;             ///< Kd.
+    int stepLimit;            ///< Largest change per step.
+    std::vector<int> waits;   ///< Waits recorded since the last step.
+    bool started;             ///< Whether the integral has been initialised.
+    double integral;          ///< Integral term, in servers.
+    double lastError;         ///< Error at the previous step.
+    double error;             ///< Error at the last step, for status().
+    double proportional;      ///< Kp·e at the last step, for status().
+    double derivative;        ///< Kd·Δe at the last step, for status().
+    int measured;             ///< p95 wait measured at the last step.
+    int commanded;            ///< Pool change requested at the last step.
+};
+
+#endif
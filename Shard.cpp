@@ -0,0 +1,457 @@
+// Shard.cpp
+
+#include "Shard.h"
+
+// empty shard with no servers
+Shard::Shard(DispatchPolicy* dispatchPolicy, QueueDiscipline discipline, int maxTime, int intervalWidth,
+             const std::vector<double>& laneWeights)
+    : requestQueue(discipline, maxTime, intervalWidth, laneWeights) {
+    policy = dispatchPolicy;
+    preemptive = discipline == QUEUE_SRPT;
+    preemptions = 0;
+    timedOut = 0;
+    lateCompletions = 0;
+    codelEnabled = false;
+    codelDrops = 0;
+    policyStale = true;
+    completedLastTick = 0;
+    busyLastTick = 0;
+    freeSlots = 0;
+    provisioning = 0;
+    provisioningRate = 0.0;
+    warming = 0;
+    draining = 0;
+}
+
+// free all servers and the policy owned by this shard
+Shard::~Shard() {
+    for (int i = 0; i < (int)servers.size(); i++) {
+        delete servers[i];
+    }
+    servers.clear();
+    for (int i = 0; i < (int)retired.size(); i++) {
+        delete retired[i];
+    }
+    retired.clear();
+    delete policy;
+}
+
+// push a request onto this shard's queue
+void Shard::enqueue(const Request& request) {
+    requestQueue.push(request);
+}
+
+// shed the next request in dispatch order
+bool Shard::dropHead() {
+    if (requestQueue.empty()) {
+        return false;
+    }
+    requestQueue.discard();
+    return true;
+}
+
+// replace the default controller with one using the configured timings
+void Shard::enableCoDel(int target, int interval) {
+    codel = CoDelController(target, interval);
+    codelEnabled = true;
+}
+
+// take the oldest requests from another shard's queue
+int Shard::stealFrom(Shard& victim, int count) {
+    int moved = 0;
+    while (moved < count && !victim.requestQueue.empty()) {
+        requestQueue.push(victim.requestQueue.front());
+        victim.requestQueue.discard();
+        moved++;
+    }
+    return moved;
+}
+
+// add a server to the end of this shard's pool
+void Shard::addServer(WebServer* server) {
+    servers.push_back(server);
+    policyStale = true;
+    if (server->isProvisioning()) {
+        provisioning++;
+        provisioningRate += server->serviceRate();
+    } else {
+        freeSlots += server->slotCount() - server->activeRequests();
+    }
+    if (server->isWarmingUp()) {
+        warming++;
+    }
+}
+
+// hand back idle servers from the back (newest, so still-booting ones go first), then close the gaps in one pass
+int Shard::removeIdleServers(int count, std::vector<WebServer*>& removed) {
+    int taken = 0;
+    for (int i = (int)servers.size() - 1; i >= 0 && taken < count; i--) {
+        if (servers[i]->activeRequests() == 0 && !servers[i]->isDraining()) {
+            if (servers[i]->isProvisioning()) {
+                provisioning--;
+                provisioningRate -= servers[i]->serviceRate();
+            } else {
+                freeSlots -= servers[i]->slotCount();
+            }
+            if (servers[i]->isWarmingUp()) {
+                warming--;
+            }
+            removed.push_back(servers[i]);
+            servers[i] = nullptr;
+            taken++;
+        }
+    }
+    if (taken == 0) {
+        return 0;
+    }
+
+    int kept = 0;
+    for (int i = 0; i < (int)servers.size(); i++) {
+        if (servers[i] != nullptr) {
+            servers[kept++] = servers[i];
+        }
+    }
+    servers.resize(kept);
+    policyStale = true;
+    return taken;
+}
+
+// stop busy servers taking work; they leave the pool in processTick() once empty
+int Shard::drainBusyServers(int count, int now, std::vector<WebServer*>& marked) {
+    int taken = 0;
+    for (int i = (int)servers.size() - 1; i >= 0 && taken < count; i--) {
+        if (servers[i]->isDraining() || servers[i]->activeRequests() == 0) {
+            continue;
+        }
+        freeSlots -= servers[i]->slotCount() - servers[i]->activeRequests();
+        servers[i]->drain(now);
+        marked.push_back(servers[i]);
+        taken++;
+    }
+    if (taken > 0) {
+        draining += taken;
+        policyStale = true;
+    }
+    return taken;
+}
+
+// hand over the servers retired since the last call
+void Shard::takeRetired(std::vector<WebServer*>& out) {
+    out.insert(out.end(), retired.begin(), retired.end());
+    retired.clear();
+}
+
+// getter for the draining server count
+int Shard::drainingCount() const {
+    return draining;
+}
+
+// getter for the drain duration histogram
+const Histogram& Shard::drainHistogram() const {
+    return drainTimes;
+}
+
+// getter for the server list
+const std::vector<WebServer*>& Shard::serverList() const {
+    return servers;
+}
+
+// hand queued requests to the servers the policy picks, then tick all servers
+void Shard::processTick(int cycle, LogLevel logLevel) {
+    tickWaits.clear();
+    // pool changed since last cycle, so let the policy re-index it once
+    if (policyStale) {
+        policy->rebuild(servers, cycle);
+        policyStale = false;
+    }
+
+    // only the requests that come due this cycle are visited, wherever they sit in the queue
+    expiredScratch.clear();
+    timedOut += requestQueue.removeExpired(cycle, expiredScratch);
+    if constexpr (LOG_COMPILED_LEVEL >= LOG_REQUEST) {
+        for (int i = 0; logLevel >= LOG_REQUEST && i < (int)expiredScratch.size(); i++) {
+            logEvents.push_back(AsyncLogger::makeRecord(LOG_TIMEOUT, cycle, expiredScratch[i], cycle - expiredScratch[i].enqueueTime, ""));
+        }
+    }
+
+    while (!requestQueue.empty()) {
+        const Request& head = requestQueue.front();
+        if (codelEnabled && head.startTime < 0 && codel.shouldDrop(cycle - head.enqueueTime, cycle)) {
+            if constexpr (LOG_COMPILED_LEVEL >= LOG_REQUEST) {
+                if (logLevel >= LOG_REQUEST) {
+                    logEvents.push_back(AsyncLogger::makeRecord(LOG_CODEL_DROP, cycle, head, cycle - head.enqueueTime, ""));
+                }
+            }
+            requestQueue.discard();
+            codelDrops++;
+            continue;
+        }
+
+        int target = policy->pick(head, cycle);
+        if (target < 0) {
+            break;
+        }
+
+        Request next = requestQueue.front();
+        requestQueue.pop();
+        assign(next, servers[target], cycle, logLevel);
+        policy->onAssigned(target, next, cycle);
+    }
+
+    // every slot is busy; under SRPT shorter queued work displaces longer running work
+    if (preemptive) {
+        while (!requestQueue.empty() && preemptLongest(cycle, logLevel)) {
+        }
+    }
+
+    completedLastTick = 0;
+    busyLastTick = 0;
+    freeSlots = 0;
+    bool anyRetired = false;
+    for (int i = 0; i < (int)servers.size(); i++) {
+        finishedJobs.clear();
+        bool booting = servers[i]->isProvisioning();
+        bool warmingUp = servers[i]->isWarmingUp();
+        if (servers[i]->activeRequests() > 0) {
+            busyLastTick++;
+        }
+        int finished = servers[i]->processTick(&finishedJobs);
+        if (booting && !servers[i]->isProvisioning()) {
+            // came online without an assignment or completion, so the policy index must be rebuilt
+            provisioning--;
+            provisioningRate -= servers[i]->serviceRate();
+            policyStale = true;
+            warmingUp = servers[i]->isWarmingUp();
+            if (warmingUp) {
+                warming++;
+            }
+        }
+        if (warmingUp && !servers[i]->isWarmingUp()) {
+            warming--;
+        }
+        if (finished > 0) {
+            completedLastTick += finished;
+            for (int j = 0; j < (int)finishedJobs.size(); j++) {
+                int response = cycle + 1 - finishedJobs[j].enqueueTime;
+                responseTimes.record(response);
+                serviceTimes.record(cycle + 1 - finishedJobs[j].startTime);
+                laneResponses[FairQueue::laneFor(finishedJobs[j].jobType)].record(response);
+                if (finishedJobs[j].timeout >= 0 && response > finishedJobs[j].timeout) {
+                    lateCompletions++;
+                }
+                if constexpr (LOG_COMPILED_LEVEL >= LOG_TRACE) {
+                    if (logLevel >= LOG_TRACE) {
+                        logEvents.push_back(AsyncLogger::makeCompletion(cycle, finishedJobs[j].requestId, response, servers[i]->id()));
+                    }
+                }
+                // only FCFS jobs are tracked for preemption, so a PS job is not found
+                if (preemptive) {
+                    std::unordered_map<int, RunningJob>::iterator it = running.find(finishedJobs[j].requestId);
+                    if (it != running.end()) {
+                        runningByFinish.erase(std::make_pair(it->second.finishCycle, it->first));
+                        running.erase(it);
+                    }
+                }
+            }
+            policy->onCompleted(i, cycle);
+        }
+        if (servers[i]->isDraining()) {
+            if (servers[i]->activeRequests() == 0) {
+                drainTimes.record(cycle + 1 - servers[i]->drainStartCycle());
+                if (servers[i]->isWarmingUp()) {
+                    warming--;
+                }
+                draining--;
+                retired.push_back(servers[i]);
+                servers[i] = nullptr;
+                anyRetired = true;
+            }
+        } else if (!servers[i]->isProvisioning()) {
+            freeSlots += servers[i]->slotCount() - servers[i]->activeRequests();
+        }
+    }
+
+    // one compaction for every server retired this tick
+    if (anyRetired) {
+        int kept = 0;
+        for (int i = 0; i < (int)servers.size(); i++) {
+            if (servers[i] != nullptr) {
+                servers[kept++] = servers[i];
+            }
+        }
+        servers.resize(kept);
+        policyStale = true;
+    }
+}
+
+// start a request on a server, recording its wait the first time it runs
+void Shard::assign(Request& next, WebServer* server, int cycle, LogLevel logLevel) {
+    if (next.startTime < 0) {
+        next.startTime = cycle;
+        waitTimes.record(cycle - next.enqueueTime);
+        tickWaits.push_back(cycle - next.enqueueTime);
+        laneWaits[FairQueue::laneFor(next.jobType)].record(cycle - next.enqueueTime);
+    }
+    // buffered here, written to the file by the main thread
+    if constexpr (LOG_COMPILED_LEVEL >= LOG_TRACE) {
+        if (logLevel >= LOG_TRACE) {
+            logEvents.push_back(AsyncLogger::makeRecord(LOG_ASSIGNED, cycle, next, next.timeRequired, server->id()));
+        }
+    }
+    server->processRequest(&next);
+
+    if (preemptive && server->mode() == SERVICE_FCFS) {
+        RunningJob job;
+        job.request = next;
+        job.finishCycle = cycle + next.timeRequired / server->speed();
+        job.finishTag = server->workClock() + next.timeRequired;
+        job.server = server;
+        running[next.id] = job;
+        runningByFinish.insert(std::make_pair(job.finishCycle, next.id));
+    }
+}
+
+// swap the longest running request for the queue front if the front is shorter
+bool Shard::preemptLongest(int cycle, LogLevel logLevel) {
+    // latest finish first, skipping draining servers: they must not be handed new work
+    std::set<std::pair<double, int> >::iterator last = runningByFinish.end();
+    std::unordered_map<int, RunningJob>::iterator it;
+    WebServer* server = nullptr;
+    while (last != runningByFinish.begin()) {
+        --last;
+        it = running.find(last->second);
+        if (!it->second.server->isDraining()) {
+            server = it->second.server;
+            break;
+        }
+    }
+    if (server == nullptr) {
+        return false;
+    }
+    // work units straight from the server clock; a whole unit of margin stops equal sizes swapping back and forth
+    double left = it->second.finishTag - server->workClock();
+    if (requestQueue.front().timeRequired > left - 1.0) {
+        return false;
+    }
+
+    int remaining = 0;
+    server->preempt(it->first, remaining);
+    Request resumed = it->second.request;
+    resumed.timeRequired = remaining;
+    runningByFinish.erase(last);
+    running.erase(it);
+    preemptions++;
+    if constexpr (LOG_COMPILED_LEVEL >= LOG_TRACE) {
+        if (logLevel >= LOG_TRACE) {
+            logEvents.push_back(AsyncLogger::makeRecord(LOG_PREEMPTED, cycle, resumed, remaining, server->id()));
+        }
+    }
+
+    // the freed slot goes to the shorter request; the slot count is unchanged so the policy index stays valid
+    Request next = requestQueue.front();
+    requestQueue.pop();
+    requestQueue.push(resumed);
+    assign(next, server, cycle, logLevel);
+    return true;
+}
+
+// getter for queue depth
+int Shard::queueSize() const {
+    return requestQueue.size();
+}
+
+// getter for server count
+int Shard::serverCount() const {
+    return (int)servers.size();
+}
+
+// getter for the cached free slot count
+int Shard::freeSlotCount() const {
+    return freeSlots;
+}
+
+// getter for the provisioning server count
+int Shard::provisioningCount() const {
+    return provisioning;
+}
+
+// getter for the capacity still provisioning
+double Shard::provisioningCapacity() const {
+    return provisioningRate;
+}
+
+// getter for the warm-up server count
+int Shard::warmingUpCount() const {
+    return warming;
+}
+
+// getter for last tick's completions
+int Shard::completedThisTick() const {
+    return completedLastTick;
+}
+
+// getter for last tick's busy servers
+int Shard::busyThisTick() const {
+    return busyLastTick;
+}
+
+// getter for the wait-time histogram
+const Histogram& Shard::waitHistogram() const {
+    return waitTimes;
+}
+
+// getter for this tick's waits
+const std::vector<int>& Shard::lastTickWaits() const {
+    return tickWaits;
+}
+
+// getter for the response-time histogram
+const Histogram& Shard::responseHistogram() const {
+    return responseTimes;
+}
+
+// getter for the service-time histogram
+const Histogram& Shard::serviceHistogram() const {
+    return serviceTimes;
+}
+
+// getter for the timed-out counter
+long long Shard::timedOutCount() const {
+    return timedOut;
+}
+
+// getter for the late-completion counter
+long long Shard::lateCount() const {
+    return lateCompletions;
+}
+
+// getter for the CoDel drop counter
+long long Shard::codelDropCount() const {
+    return codelDrops;
+}
+
+// getter for the policy's affinity counters
+AffinityStats Shard::affinityStats() const {
+    return policy->affinityStats();
+}
+
+// getter for one job type's wait histogram
+const Histogram& Shard::waitHistogram(int lane) const {
+    return laneWaits[lane];
+}
+
+// getter for one job type's response histogram
+const Histogram& Shard::responseHistogram(int lane) const {
+    return laneResponses[lane];
+}
+
+// getter for the preemption counter
+long long Shard::preemptionCount() const {
+    return preemptions;
+}
+
+// hand the buffered log records to the caller
+void Shard::drainLog(std::vector<LogRecord>& out) {
+    out.insert(out.end(), logEvents.begin(), logEvents.end());
+    logEvents.clear();
+}
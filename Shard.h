@@ -0,0 +1,286 @@
+/**
+ * @file Shard.h
+ * @brief Defines the Shard class, one partition of the server pool and
+ *        request queue that can be ticked independently of the others.
+ *
+ * @author Karan Bhagat
+ * @date 2026
+ */
+
+#ifndef SHARD_H
+#define SHARD_H
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "AsyncLogger.h"
+#include "DispatchPolicy.h"
+#include "Histogram.h"
+#include "LoadShedding.h"
+#include "Request.h"
+#include "FairQueue.h"
+#include "RequestQueue.h"
+#include "WebServer.h"
+
+/**
+ * @class Shard
+ * @brief A slice of the load balancer: its own request queue and its own servers.
+ *
+ * The LoadBalancer splits its pool into one Shard per worker thread. During
+ * the parallel phase of a cycle each shard only touches its own members, so
+ * shards can be ticked concurrently without locks. Anything that crosses
+ * shards (arrivals, work stealing, scaling, file logging) is done by the
+ * LoadBalancer on the main thread between parallel phases.
+ */
+class Shard {
+public:
+    /**
+     * @brief Constructs an empty shard.
+     * @param dispatchPolicy Policy that picks servers for this shard's
+     *                       requests; owned and deleted by the shard.
+     * @param discipline     Order in which queued requests are dispatched.
+     * @param maxTime        Largest request size, for the size-ordered queues.
+     * @param intervalWidth  Size interval width for QUEUE_SIZE_INTERVAL.
+     * @param laneWeights    Per-job-type DRR weights; empty for one shared queue.
+     */
+    Shard(DispatchPolicy* dispatchPolicy, QueueDiscipline discipline = QUEUE_FIFO, int maxTime = 0, int intervalWidth = 1,
+          const std::vector<double>& laneWeights = std::vector<double>());
+
+    /**
+     * @brief Destructor. Frees every WebServer owned by this shard and its policy.
+     */
+    ~Shard();
+
+    /**
+     * @brief Adds a request to this shard's queue.
+     * @param request Request that has already passed the firewall.
+     */
+    void enqueue(const Request& request);
+
+    /**
+     * @brief Drops the request this shard would dispatch next (drop-oldest shedding).
+     * @return @c true if a request was dropped; @c false if the queue was empty.
+     */
+    bool dropHead();
+
+    /**
+     * @brief Turns on CoDel shedding at dequeue time for this shard.
+     * @param target   Target queue delay, in cycles.
+     * @param interval CoDel interval, in cycles.
+     */
+    void enableCoDel(int target, int interval);
+
+    /**
+     * @brief Moves up to @p count requests from the front of @p victim's
+     *        queue (the ones it would serve next) into this shard's queue.
+     * @param victim Shard to steal from.
+     * @param count  Maximum number of requests to move.
+     * @return Number of requests actually moved.
+     */
+    int stealFrom(Shard& victim, int count);
+
+    /**
+     * @brief Takes ownership of a newly created server.
+     * @param server Heap-allocated server; deleted by this shard.
+     */
+    void addServer(WebServer* server);
+
+    /**
+     * @brief Detaches up to @p count idle servers (no active requests),
+     *        searching from the back of the pool.
+     *
+     * One scan and one compaction of the server list, however many
+     * servers are taken.
+     *
+     * @param count   Maximum number of servers to detach.
+     * @param removed Detached servers are appended here; the caller now owns them.
+     * @return Number of servers detached.
+     */
+    int removeIdleServers(int count, std::vector<WebServer*>& removed);
+
+    /**
+     * @brief Marks up to @p count busy servers as draining, searching from
+     *        the back of the pool.
+     *
+     * Draining servers take no new work and are retired by processTick()
+     * once their last active request completes; collect them with
+     * takeRetired().
+     *
+     * @param count  Maximum number of servers to mark.
+     * @param now    Current simulation cycle.
+     * @param marked Servers marked are appended here; the shard still owns them.
+     * @return Number of servers marked.
+     */
+    int drainBusyServers(int count, int now, std::vector<WebServer*>& marked);
+
+    /**
+     * @brief Hands over the servers that finished draining since the last call.
+     * @param out Retired servers are appended here; the caller now owns them.
+     */
+    void takeRetired(std::vector<WebServer*>& out);
+
+    /** @brief Servers owned by this shard that are draining and not yet retired. */
+    int drainingCount() const;
+
+    /** @brief Cycles from drain() to retirement of every server this shard retired. */
+    const Histogram& drainHistogram() const;
+
+    /** @brief Servers currently owned by this shard. */
+    const std::vector<WebServer*>& serverList() const;
+
+    /**
+     * @brief Runs one cycle for this shard only.
+     *
+     * Requests whose client timed out this cycle are dropped first, from
+     * anywhere in the queue, through the queue's deadline index, so expiry
+     * costs nothing per cycle for requests that are still valid. Queued
+     * requests are then handed, in queue order, to the server chosen by
+     * the dispatch policy until the queue is empty or no server can take
+     * more work; each request's queue wait is recorded. With CoDel enabled the head may also be shed when its queue delay has
+     * stayed above target. Under SRPT with
+     * FCFS servers, a queued request smaller than the largest remaining
+     * running request then preempts it and the preempted remainder goes
+     * back into the queue. Then every server is ticked; a server that
+     * finishes provisioning marks the policy index for a rebuild, since it
+     * became available without an assignment or completion, and a draining
+     * server whose last request finished is moved out of the pool to the
+     * retired list. Completions are
+     * counted in completedThisTick() and their response times recorded.
+     * At LOG_REQUEST a LogRecord per timeout and CoDel drop, and at
+     * LOG_TRACE one per dispatch, preemption and completion, is appended
+     * to the shard's log buffer.
+     *
+     * @param cycle    Current simulation cycle.
+     * @param logLevel Level of the log file (LOG_OFF if there is none).
+     */
+    void processTick(int cycle, LogLevel logLevel);
+
+    /** @brief Number of requests waiting in this shard's queue. */
+    int queueSize() const;
+
+    /** @brief Number of servers owned by this shard. */
+    int serverCount() const;
+
+    /** @brief Number of free server slots, as of the last tick or pool change; provisioning servers have none. */
+    int freeSlotCount() const;
+
+    /** @brief Servers still provisioning (WebServer::isProvisioning()). */
+    int provisioningCount() const;
+
+    /** @brief Sum of WebServer::serviceRate() over the servers still provisioning. */
+    double provisioningCapacity() const;
+
+    /** @brief Servers serving at reduced warm-up speed (WebServer::isWarmingUp()). */
+    int warmingUpCount() const;
+
+    /** @brief Requests completed by this shard during the last processTick(). */
+    int completedThisTick() const;
+
+    /** @brief Servers that had at least one active request during the last processTick(). */
+    int busyThisTick() const;
+
+    /** @brief Queue wait (cycles) of every request this shard dispatched. */
+    const Histogram& waitHistogram() const;
+
+    /** @brief Queue waits of the requests dispatched during the last processTick(). */
+    const std::vector<int>& lastTickWaits() const;
+
+    /** @brief Enqueue-to-completion time (cycles) of every request this shard finished. */
+    const Histogram& responseHistogram() const;
+
+    /** @brief First-dispatch-to-completion time (cycles) of every request this shard finished. */
+    const Histogram& serviceHistogram() const;
+
+    /**
+     * @brief Queue wait of the requests of one job type.
+     * @param lane FairQueue::laneFor() of the job type.
+     */
+    const Histogram& waitHistogram(int lane) const;
+
+    /**
+     * @brief Response time of the requests of one job type.
+     * @param lane FairQueue::laneFor() of the job type.
+     */
+    const Histogram& responseHistogram(int lane) const;
+
+    /** @brief Running requests preempted by shorter queued ones (SRPT only). */
+    long long preemptionCount() const;
+
+    /** @brief Requests dropped from the queue because their client timed out. */
+    long long timedOutCount() const;
+
+    /** @brief Requests that completed after their client's timeout. */
+    long long lateCount() const;
+
+    /** @brief Requests dropped at dequeue by CoDel. */
+    long long codelDropCount() const;
+
+    /** @brief The dispatch policy's affinity counters (all zero for non-affinity policies). */
+    AffinityStats affinityStats() const;
+
+    /**
+     * @brief Returns and clears the log records buffered since the last call.
+     * @param out Vector the buffered records are appended to, in event order.
+     */
+    void drainLog(std::vector<LogRecord>& out);
+
+private:
+    /**
+     * @struct RunningJob
+     * @brief A request in service, remembered so SRPT can preempt it.
+     */
+    struct RunningJob {
+        Request request;    ///< The request as dispatched.
+        double finishCycle; ///< Cycle its FCFS slot finishes it (orders candidates only).
+        double finishTag;   ///< Server work clock at which it finishes.
+        WebServer* server;  ///< Server running it.
+    };
+
+    /** @brief Starts @p next on @p server and records its wait if it never ran before. */
+    void assign(Request& next, WebServer* server, int cycle, LogLevel logLevel);
+
+    /**
+     * @brief Preempts the running request with the most remaining work on a
+     *        server that is not draining if the queue front is smaller by
+     *        at least one unit of work, and runs the queue front in its place.
+     * @return @c true if a preemption happened.
+     */
+    bool preemptLongest(int cycle, LogLevel logLevel);
+
+    FairQueue requestQueue;             ///< Requests routed to this shard, in dispatch order.
+    std::vector<WebServer*> servers;    ///< Servers owned by this shard.
+    DispatchPolicy* policy;             ///< Chooses the server for each dispatched request.
+    bool policyStale;                   ///< Set when the pool changed since the last rebuild.
+    Histogram waitTimes;                ///< Queue wait of every dispatched request.
+    Histogram responseTimes;            ///< Enqueue-to-completion time of every finished request.
+    Histogram serviceTimes;             ///< First-dispatch-to-completion time of every finished request.
+    std::vector<int> tickWaits;         ///< Waits recorded by the current/last processTick().
+    Histogram laneWaits[FairQueue::LANE_COUNT];     ///< waitTimes split by job type.
+    Histogram laneResponses[FairQueue::LANE_COUNT]; ///< responseTimes split by job type.
+    std::vector<ActiveJob> finishedJobs; ///< Scratch list filled by WebServer::processTick().
+    bool preemptive;                    ///< SRPT discipline: track running requests for preemption.
+    std::unordered_map<int, RunningJob> running;           ///< In-service requests by id (SRPT only).
+    std::set<std::pair<double, int> > runningByFinish;     ///< (finishCycle, id) of in-service requests (SRPT only).
+    long long preemptions;              ///< Preemptions performed.
+    long long timedOut;                 ///< Requests expired in the queue.
+    std::vector<Request> expiredScratch; ///< Reused buffer for requests expired this tick.
+    long long lateCompletions;          ///< Requests finished after their timeout.
+    CoDelController codel;              ///< Dequeue-time shedding state.
+    bool codelEnabled;                  ///< Whether CoDel shedding is on.
+    long long codelDrops;               ///< Requests dropped by CoDel.
+    int completedLastTick;              ///< Completions counted by the last processTick().
+    int busyLastTick;                   ///< Servers busy during the last processTick().
+    int freeSlots;                      ///< Free server slots, kept current without rescanning.
+    int provisioning;                   ///< Servers still provisioning.
+    double provisioningRate;            ///< Their summed service rate.
+    int warming;                        ///< Servers in warm-up.
+    int draining;                       ///< Servers draining and not yet retired.
+    std::vector<WebServer*> retired;    ///< Drained servers waiting for takeRetired().
+    Histogram drainTimes;               ///< Drain duration of every retired server.
+    std::vector<LogRecord> logEvents;   ///< Pending per-request log records for the log file.
+};
+
+#endif
@@ -0,0 +1,123 @@
+// TimeSeries.cpp
+
+#include "TimeSeries.h"
+#include <cstdint>
+
+// widen the window until the run fits, then allocate every row
+TimeSeries::TimeSeries(int totalCycles, int window, int maxRows) {
+    if (totalCycles < 1) {
+        totalCycles = 1;
+    }
+    if (maxRows < 1) {
+        maxRows = 1;
+    }
+    windowCycles = window < 1 ? 1 : window;
+    long long needed = (totalCycles + (long long)maxRows - 1) / maxRows;
+    if (needed > windowCycles) {
+        windowCycles = (int)needed;
+    }
+    int capacity = (int)((totalCycles + (long long)windowCycles - 1) / windowCycles);
+    for (int c = 0; c < TS_COLUMN_COUNT; c++) {
+        mins[c].resize(capacity);
+        maxs[c].resize(capacity);
+        means[c].resize(capacity);
+    }
+    rowCount = 0;
+    cycleCount = 0;
+    filled = 0;
+}
+
+// fold the sample into the open window
+void TimeSeries::record(const int* sample) {
+    if (rowCount == (int)mins[0].size()) {
+        // more cycles than the constructor was told about
+        return;
+    }
+    if (filled == 0) {
+        for (int c = 0; c < TS_COLUMN_COUNT; c++) {
+            windowMin[c] = sample[c];
+            windowMax[c] = sample[c];
+            windowSum[c] = sample[c];
+        }
+    } else {
+        for (int c = 0; c < TS_COLUMN_COUNT; c++) {
+            if (sample[c] < windowMin[c]) {
+                windowMin[c] = sample[c];
+            }
+            if (sample[c] > windowMax[c]) {
+                windowMax[c] = sample[c];
+            }
+            windowSum[c] += sample[c];
+        }
+    }
+    filled++;
+    cycleCount++;
+    if (filled == windowCycles) {
+        closeRow();
+    }
+}
+
+// the last window may be short
+void TimeSeries::finish() {
+    if (filled > 0) {
+        closeRow();
+    }
+}
+
+// getter for cycles per row
+int TimeSeries::window() const {
+    return windowCycles;
+}
+
+// getter for rows written
+int TimeSeries::rows() const {
+    return rowCount;
+}
+
+// header, then cycle range and min/max/mean of every column per row
+void TimeSeries::writeCsv(std::ostream& out) const {
+    out << "cycle_start,cycle_end";
+    for (int c = 0; c < TS_COLUMN_COUNT; c++) {
+        out << ',' << columnName(c) << "_min," << columnName(c) << "_max," << columnName(c) << "_mean";
+    }
+    out << '\n';
+    for (int r = 0; r < rowCount; r++) {
+        int start = r * windowCycles + 1;
+        int end = r == rowCount - 1 ? cycleCount : (r + 1) * windowCycles;
+        out << start << ',' << end;
+        for (int c = 0; c < TS_COLUMN_COUNT; c++) {
+            out << ',' << mins[c][r] << ',' << maxs[c][r] << ',' << means[c][r];
+        }
+        out << '\n';
+    }
+}
+
+// header, then each column's arrays written straight from memory
+void TimeSeries::writeBinary(std::ostream& out) const {
+    out.write("LBTS", 4);
+    out.put((char)1);
+    int32_t header[4] = {TS_COLUMN_COUNT, windowCycles, rowCount, cycleCount};
+    out.write((const char*)header, sizeof(header));
+    for (int c = 0; c < TS_COLUMN_COUNT; c++) {
+        out.write((const char*)mins[c].data(), rowCount * sizeof(int));
+        out.write((const char*)maxs[c].data(), rowCount * sizeof(int));
+        out.write((const char*)means[c].data(), rowCount * sizeof(double));
+    }
+}
+
+// CSV header names
+const char* TimeSeries::columnName(int column) {
+    static const char* const NAMES[TS_COLUMN_COUNT] = {"queue", "busy", "servers", "arrivals", "completions", "blocked"};
+    return column >= 0 && column < TS_COLUMN_COUNT ? NAMES[column] : "";
+}
+
+// copy the open window into the next row
+void TimeSeries::closeRow() {
+    for (int c = 0; c < TS_COLUMN_COUNT; c++) {
+        mins[c][rowCount] = windowMin[c];
+        maxs[c][rowCount] = windowMax[c];
+        means[c][rowCount] = (double)windowSum[c] / filled;
+    }
+    rowCount++;
+    filled = 0;
+}
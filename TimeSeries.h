@@ -0,0 +1,101 @@
+/**
+ * @file TimeSeries.h
+ * @brief Defines the TimeSeries recorder that keeps per-cycle load metrics
+ *        as min/max/mean per window in preallocated columns.
+ *
+ * @author Karan Bhagat
+ * @date 2026
+ */
+
+#ifndef TIMESERIES_H
+#define TIMESERIES_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @enum TimeSeriesColumn
+ * @brief Metrics sampled once per cycle, in column order.
+ */
+enum TimeSeriesColumn {
+    TS_QUEUE,       ///< Requests queued at the end of the cycle.
+    TS_BUSY,        ///< Servers with at least one active request.
+    TS_SERVERS,     ///< Servers in the pool (booting ones included, draining ones not).
+    TS_ARRIVALS,    ///< Requests admitted to the queue this cycle.
+    TS_COMPLETIONS, ///< Requests finished this cycle.
+    TS_BLOCKED,     ///< Requests rejected by the firewall this cycle.
+    TS_COLUMN_COUNT
+};
+
+/**
+ * @class TimeSeries
+ * @brief Bounded per-cycle recorder with min/max/mean downsampling.
+ *
+ * Each window of @c window() consecutive cycles becomes one row holding
+ * the minimum, maximum and mean of every column over those cycles. The
+ * window is the configured one, widened if needed so the whole run fits in
+ * @c maxRows rows; all rows are allocated up front, so record() is a few
+ * compares and adds with no allocation, and a run of any length produces a
+ * bounded output.
+ *
+ * Storage is columnar (one array per statistic per column), which is also
+ * the layout of the binary output:
+ *  - header: @c "LBTS", version byte 1, then int32 column count, window,
+ *    row count and last cycle recorded;
+ *  - per column in TimeSeriesColumn order: @c rows int32 minimums,
+ *    @c rows int32 maximums, @c rows float64 means.
+ * Numbers are in host byte order. Row @c r covers cycles
+ * @c r*window+1 to @c min((r+1)*window, last cycle).
+ */
+class TimeSeries {
+public:
+    /**
+     * @brief Allocates every row the run can need.
+     * @param totalCycles Cycles the run will record.
+     * @param window      Requested cycles per row (at least 1).
+     * @param maxRows     Most rows to keep (at least 1); widens the window if needed.
+     */
+    TimeSeries(int totalCycles, int window, int maxRows);
+
+    /**
+     * @brief Adds one cycle's sample, closing the row once its window is full.
+     * @param sample One value per TimeSeriesColumn.
+     */
+    void record(const int* sample);
+
+    /** @brief Closes a partially filled last row. */
+    void finish();
+
+    /** @brief Cycles per row. */
+    int window() const;
+
+    /** @brief Rows closed so far. */
+    int rows() const;
+
+    /** @brief Writes one CSV row per window, with a header line. */
+    void writeCsv(std::ostream& out) const;
+
+    /** @brief Writes the columns in the binary layout described above. */
+    void writeBinary(std::ostream& out) const;
+
+    /** @brief Name of a column in the CSV header (e.g. "queue"). */
+    static const char* columnName(int column);
+
+private:
+    /** @brief Stores the current window as a row and starts a new one. */
+    void closeRow();
+
+    int windowCycles;                            ///< Cycles per row.
+    int rowCount;                                ///< Rows closed.
+    int cycleCount;                              ///< Cycles recorded.
+    int filled;                                  ///< Cycles in the open window.
+    int windowMin[TS_COLUMN_COUNT];              ///< Open window minimums.
+    int windowMax[TS_COLUMN_COUNT];              ///< Open window maximums.
+    long long windowSum[TS_COLUMN_COUNT];        ///< Open window sums.
+    std::vector<int> mins[TS_COLUMN_COUNT];      ///< Per-row minimums.
+    std::vector<int> maxs[TS_COLUMN_COUNT];      ///< Per-row maximums.
+    std::vector<double> means[TS_COLUMN_COUNT];  ///< Per-row means.
+};
+
+#endif
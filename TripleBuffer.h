@@ -0,0 +1,76 @@
+/**
+ * @file TripleBuffer.h
+ * @brief Defines the TripleBuffer class template, a lock-free way for one
+ *        thread to publish the latest version of a value to one reader.
+ *
+ * @author Karan Bhagat
+ * @date 2026
+ */
+
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+/**
+ * @class TripleBuffer
+ * @brief Single-writer/single-reader "latest value" exchange.
+ *
+ * Three slots: the writer owns one (back), the reader owns one (front) and
+ * the third sits in the middle. publish() swaps the back slot into the
+ * middle and update() swaps the middle into the front, each with a single
+ * atomic exchange, so neither side ever waits for the other and the reader
+ * always sees a complete value. Unlike SpscRing nothing queues up: the
+ * reader gets the newest value and intermediate ones are overwritten.
+ *
+ * @tparam T Value type; must be default-constructible and copyable.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : middle(1) {
+        back = 0;
+        front = 2;
+    }
+
+    /**
+     * @brief Writer side: the slot to fill before the next publish().
+     * @return The writer's slot; its contents are whatever was there last (not cleared).
+     */
+    T& writeSlot() {
+        return slots[back];
+    }
+
+    /** @brief Writer side: makes the filled slot the latest value. */
+    void publish() {
+        back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX;
+    }
+
+    /**
+     * @brief Reader side: takes the latest published value, if there is a new one.
+     * @return @c true if read() now returns a newer value.
+     */
+    bool update() {
+        if ((middle.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return false;
+        }
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    /** @brief Reader side: the value taken by the last update(). */
+    const T& read() const {
+        return slots[front];
+    }
+
+private:
+    static const int INDEX = 3; ///< Slot bits of @c middle.
+    static const int FRESH = 4; ///< Set in @c middle by publish(), cleared by update().
+
+    T slots[3];               ///< Storage.
+    int back;                 ///< Writer's slot.
+    int front;                ///< Reader's slot.
+    std::atomic<int> middle;  ///< Slot in between, plus the FRESH flag.
+};
+
+#endif
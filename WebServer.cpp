@@ -1,54 +1,253 @@
 // WebServer.cpp
 
 #include "WebServer.h"
+#include <algorithm>
 
-// set up a new server with the given ID
-WebServer::WebServer(const std::string& id) {
+// tolerance for PS clock rounding when comparing against finish tags
+const double CLOCK_EPSILON = 1e-6;
+
+// heap order: earliest finish tag on top
+static bool laterFinish(const ActiveJob& a, const ActiveJob& b) {
+    return a.finishTag > b.finishTag;
+}
+
+// set up a new server with the given ID, slot count, mode and speed
+WebServer::WebServer(const std::string& id, int slots, ServiceMode mode, double speed, int type) {
     serverId = id;
-    isBusy = false;
-    remainingTime = 0;
-    currentRequest = nullptr;
+    slotLimit = slots < 1 ? 1 : slots;
+    serviceMode = mode;
+    speedFactor = speed > 0.0 ? speed : 1.0;
+    serverType = type;
+    ticks = 0;
+    busy = 0.0;
+    clock = 0.0;
+    tagSum = 0.0;
     completedRequests = 0;
+    bootLeft = 0;
+    warmupTotal = 0;
+    warmupLeft = 0;
+    warmupStart = 1.0;
+    drainSince = -1;
+    cache = nullptr;
+    cacheHitFactor = 1.0;
 }
 
-// clean up any leftover request
+// free the cache
 WebServer::~WebServer() {
-    delete currentRequest;
+    delete cache;
+}
+
+// start with an empty cache of the given policy and size
+void WebServer::enableCache(CachePolicy policy, int capacity, double hitFactor) {
+    delete cache;
+    cache = policy == CACHE_NONE ? nullptr : new ResponseCache(policy, capacity);
+    cacheHitFactor = hitFactor > 0.0 && hitFactor <= 1.0 ? hitFactor : 1.0;
+}
+
+// getter for cache hits
+long long WebServer::cacheHits() const {
+    return cache != nullptr ? cache->hits() : 0;
+}
+
+// getter for cache lookups
+long long WebServer::cacheLookups() const {
+    return cache != nullptr ? cache->lookups() : 0;
+}
+
+// no work until booted, then a linear ramp up to full speed
+void WebServer::coldStart(int bootCycles, int warmupCycles, double initialSpeed) {
+    bootLeft = bootCycles < 0 ? 0 : bootCycles;
+    warmupTotal = warmupCycles < 0 ? 0 : warmupCycles;
+    warmupLeft = warmupTotal;
+    warmupStart = initialSpeed > 0.0 && initialSpeed <= 1.0 ? initialSpeed : 1.0;
+}
+
+// true until the provisioning delay has passed
+bool WebServer::isProvisioning() const {
+    return bootLeft > 0;
+}
+
+// true while the warm-up ramp is still running
+bool WebServer::isWarmingUp() const {
+    return bootLeft == 0 && warmupLeft > 0;
 }
 
-// take a request if the server is free, copy it and start processing
+// take a request if a slot is free and record when it will finish
 bool WebServer::processRequest(Request* request) {
-    if (request == nullptr || isBusy) {
+    if (request == nullptr || bootLeft > 0 || drainSince >= 0 || (int)jobs.size() >= slotLimit) {
         return false;
     }
 
-    currentRequest = new Request(*request);
-    remainingTime = currentRequest->timeRequired;
-    isBusy = true;
+    // cached responses are cheaper; the key is used up so a resumed request is not looked up again
+    if (cache != nullptr && request->contentKey >= 0) {
+        if (cache->access((unsigned long long)request->contentKey)) {
+            int reduced = (int)(request->timeRequired * cacheHitFactor + 0.5);
+            request->timeRequired = reduced < 1 ? 1 : reduced;
+        }
+        request->contentKey = -1;
+    }
+
+    ActiveJob job;
+    job.finishTag = clock + request->timeRequired;
+    job.requestId = request->id;
+    job.enqueueTime = request->enqueueTime;
+    job.startTime = request->startTime;
+    job.jobType = request->jobType;
+    job.timeout = request->timeout;
+    jobs.push_back(job);
+    std::push_heap(jobs.begin(), jobs.end(), laterFinish);
+    tagSum += job.finishTag;
     return true;
 }
 
-// count down the timer, return true if the request just finished
-bool WebServer::processTick() {
-    if (!isBusy) {
-        return false;
+// advance the clock, retire every request whose tag has been reached
+int WebServer::processTick(std::vector<ActiveJob>* completed) {
+    ticks++;
+    if (bootLeft > 0) {
+        bootLeft--;
+        return 0;
     }
 
-    remainingTime--;
-    if (remainingTime <= 0) {
-        delete currentRequest;
-        currentRequest = nullptr;
-        isBusy = false;
-        completedRequests++;
-        return true;
+    // warm-up runs on wall time, busy or not
+    double rate = speedFactor;
+    if (warmupLeft > 0) {
+        rate *= warmupStart + (1.0 - warmupStart) * (warmupTotal - warmupLeft) / warmupTotal;
+        warmupLeft--;
+    }
+
+    int active = (int)jobs.size();
+    if (active == 0) {
+        return 0;
+    }
+
+    if (serviceMode == SERVICE_PS) {
+        clock += rate / active;
+        busy += 1.0;
+    } else {
+        clock += rate;
+        busy += (double)active / slotLimit;
     }
 
+    int finished = 0;
+    while (!jobs.empty() && jobs.front().finishTag <= clock + CLOCK_EPSILON) {
+        tagSum -= jobs.front().finishTag;
+        std::pop_heap(jobs.begin(), jobs.end(), laterFinish);
+        if (completed != nullptr) {
+            completed->push_back(jobs.back());
+        }
+        jobs.pop_back();
+        finished++;
+    }
+
+    // start the clock over when empty so it never drifts far from the tags
+    if (jobs.empty()) {
+        clock = 0.0;
+        tagSum = 0.0;
+    }
+
+    completedRequests += finished;
+    return finished;
+}
+
+// pull one request out of service and report how much work it still needs
+bool WebServer::preempt(int requestId, int& remainingWork) {
+    for (int i = 0; i < (int)jobs.size(); i++) {
+        if (jobs[i].requestId != requestId) {
+            continue;
+        }
+
+        double work = jobs[i].finishTag - clock;
+        remainingWork = work <= 0.0 ? 1 : (int)(work + 1.0 - CLOCK_EPSILON);
+        tagSum -= jobs[i].finishTag;
+        jobs[i] = jobs.back();
+        jobs.pop_back();
+        std::make_heap(jobs.begin(), jobs.end(), laterFinish);
+        if (jobs.empty()) {
+            clock = 0.0;
+            tagSum = 0.0;
+        }
+        return true;
+    }
     return false;
 }
 
-// returns true if server has no active request
+// refuse new work from now on; active requests run to completion
+void WebServer::drain(int now) {
+    if (drainSince < 0) {
+        drainSince = now;
+    }
+}
+
+// true once draining has started
+bool WebServer::isDraining() const {
+    return drainSince >= 0;
+}
+
+// getter for the cycle draining started
+int WebServer::drainStartCycle() const {
+    return drainSince;
+}
+
+// returns true if at least one slot is free
 bool WebServer::isAvailable() const {
-    return !isBusy;
+    return bootLeft == 0 && drainSince < 0 && (int)jobs.size() < slotLimit;
+}
+
+// number of requests in progress
+int WebServer::activeRequests() const {
+    return (int)jobs.size();
+}
+
+// getter for slot count
+int WebServer::slotCount() const {
+    return slotLimit;
+}
+
+// getter for service mode
+ServiceMode WebServer::mode() const {
+    return serviceMode;
+}
+
+// getter for speed factor
+double WebServer::speed() const {
+    return speedFactor;
+}
+
+// getter for server type index
+int WebServer::typeIndex() const {
+    return serverType;
+}
+
+// full-load throughput: FCFS slots add up, PS slots share one
+double WebServer::serviceRate() const {
+    if (serviceMode == SERVICE_PS) {
+        return speedFactor;
+    }
+    return slotLimit * speedFactor;
+}
+
+// getter for lifetime ticks
+long long WebServer::lifetimeTicks() const {
+    return ticks;
+}
+
+// getter for accumulated busy time
+double WebServer::busyTime() const {
+    return busy;
+}
+
+// work left on all active requests, rounded up
+int WebServer::remainingWork() const {
+    double work = tagSum - clock * jobs.size();
+    if (work <= 0.0) {
+        return 0;
+    }
+    return (int)(work + 1.0 - CLOCK_EPSILON);
+}
+
+// getter for the work-unit clock
+double WebServer::workClock() const {
+    return clock;
 }
 
 // getter for server ID
@@ -59,4 +258,4 @@ std::string WebServer::id() const {
 // getter for how many requests this server has finished
 int WebServer::completedCount() const {
     return completedRequests;
-}
\ No newline at end of file
+}
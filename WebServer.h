@@ -2,9 +2,10 @@
  * @file WebServer.h
  * @brief Defines the WebServer class used in the load balancer simulation.
  *
- * Each WebServer instance represents a single backend server that can handle
- * exactly one request at a time. The server counts down a processing timer
- * each clock cycle and becomes free once the timer reaches zero.
+ * Each WebServer instance represents a single backend server with a fixed
+ * number of concurrency slots and a speed factor. Slots either run
+ * independently (FCFS per slot) or share the server's capacity (processor
+ * sharing).
  *
  * @author Karan Bhagat
  * @date 2026
@@ -14,34 +15,98 @@
 #define WEBSERVER_H
 
 #include <string>
+#include <vector>
 #include "Request.h"
+#include "ResponseCache.h"
+
+/**
+ * @enum ServiceMode
+ * @brief How concurrent requests on one server share its capacity.
+ */
+enum ServiceMode {
+    SERVICE_FCFS, ///< Every slot runs its request at full speed, independently.
+    SERVICE_PS    ///< Processor sharing: n active requests each run at 1/n speed.
+};
+
+/**
+ * @struct ActiveJob
+ * @brief Compact record of one request in service on a WebServer.
+ *
+ * Only what is needed once the request finishes is kept, not the whole
+ * Request, so a server's memory grows with its active requests only.
+ */
+struct ActiveJob {
+    double finishTag; ///< Server clock value at which the request finishes.
+    int requestId;    ///< Request::id.
+    int enqueueTime;  ///< Request::enqueueTime.
+    int startTime;    ///< Request::startTime.
+    char jobType;     ///< Request::jobType.
+    int timeout;      ///< Request::timeout.
+};
 
 /**
  * @class WebServer
  * @brief Represents one backend web server in the load balancer simulation.
  *
- * A WebServer can hold at most one active request at a time. Each call to
- * processTick() advances the internal countdown timer by one cycle. When
- * the timer hits zero the request is considered complete and the server
- * returns to an idle state.
+ * A WebServer holds up to slotCount() requests at a time. Progress is
+ * tracked with a per-server clock measured in units of work: each call to
+ * processTick() advances it by the server's speed (FCFS) or by speed/n with
+ * n requests active (processor sharing), so a speed-2 server finishes a
+ * request in half its @c timeRequired. A request accepted at clock @c V
+ * with @c t cycles of work finishes once the clock reaches @c V+t, so the
+ * server only stores one small ActiveJob per request, kept in a min-heap on
+ * the finish tag. A server can also start cold (coldStart()): it accepts
+ * nothing while provisioning, then runs slower while warming up. A tick is O(1)
+ * when nothing completes and O(log slots) per completion, independent of
+ * how many slots the server has.
  */
 class WebServer {
 public:
     /**
      * @brief Constructs a WebServer with the given identifier.
      * @param serverId Unique string label for this server (e.g. "S1").
+     * @param slots    Maximum concurrent requests (minimum 1).
+     * @param mode     How concurrent requests share the server.
+     * @param speed    Work units processed per cycle per slot (must be > 0).
+     * @param type     Index of the server type in Config::serverTypes.
      */
-    WebServer(const std::string& serverId);
+    WebServer(const std::string& serverId, int slots = 1, ServiceMode mode = SERVICE_FCFS, double speed = 1.0, int type = 0);
+
+    /** @brief Destructor. Frees the response cache, if any. */
+    ~WebServer();
+
+    WebServer(const WebServer&) = delete;
+    WebServer& operator=(const WebServer&) = delete;
 
     /**
-     * @brief Destructor. Releases any request currently held by this server.
+     * @brief Gives the server a response cache, empty (cold) to begin with.
+     *
+     * Each accepted request with a Request::contentKey is looked up; a hit
+     * cuts its timeRequired to @p hitFactor of the original (at least one
+     * cycle).
+     *
+     * @param policy    CACHE_LRU or CACHE_TINYLFU; CACHE_NONE leaves the server uncached.
+     * @param capacity  Keys the cache holds.
+     * @param hitFactor Fraction of the work a hit still costs, in (0, 1].
      */
-    ~WebServer();
+    void enableCache(CachePolicy policy, int capacity, double hitFactor);
+
+    /** @brief Requests that hit the response cache. */
+    long long cacheHits() const;
+
+    /** @brief Requests looked up in the response cache. */
+    long long cacheLookups() const;
 
     /**
-     * @brief Assigns a request to this server if it is currently idle.
-     * @param request Pointer to the Request to process.
-     * @return @c true if the request was accepted; @c false if the server
+     * @brief Assigns a request to this server if it has a free slot.
+     *
+     * With a cache, the request's content key is looked up first and
+     * cleared, so a request preempted and resumed elsewhere is not looked
+     * up twice; a hit shortens its timeRequired in place.
+     *
+     * @param request Pointer to the Request to process; its timeRequired is
+     *                the work still to do.
+     * @return @c true if the request was accepted; @c false if every slot
      *         is already busy.
      */
     bool processRequest(Request* request);
@@ -49,21 +114,121 @@ public:
     /**
      * @brief Advances the server by one simulation clock cycle.
      *
-     * Decrements the remaining processing time of the current request by one.
-     * When the timer reaches zero the request is finished, the completed
-     * counter is incremented, and the server becomes idle again.
+     * Moves the server clock forward and retires every request whose finish
+     * tag has been reached, incrementing the completed counter for each.
+     * Also accumulates the lifetime and busy time used for utilization.
      *
-     * @return @c true if a request completed during this tick; @c false
-     *         otherwise.
+     * @param completed If not @c nullptr, each finished request's record is appended.
+     * @return Number of requests that completed during this tick.
+     */
+    int processTick(std::vector<ActiveJob>* completed = nullptr);
+
+    /**
+     * @brief Removes an active request before it finishes (SRPT preemption).
+     * @param requestId     Request::id of the request to remove.
+     * @param remainingWork Output: work left on it, rounded up to whole speed-1 cycles.
+     * @return @c true if the request was found and removed.
+     */
+    bool preempt(int requestId, int& remainingWork);
+
+    /**
+     * @brief Puts a freshly created server through a cold start.
+     *
+     * For @p bootCycles ticks the server accepts no work. After that it
+     * runs at @p initialSpeed of its speed, ramping linearly back to full
+     * speed over @p warmupCycles ticks.
+     *
+     * @param bootCycles   Provisioning delay before the first request, in cycles.
+     * @param warmupCycles Length of the reduced-speed period, in cycles.
+     * @param initialSpeed Fraction of full speed at the start of warm-up, in (0, 1].
+     */
+    void coldStart(int bootCycles, int warmupCycles, double initialSpeed);
+
+    /** @brief @c true while the server is still provisioning and accepts no work. */
+    bool isProvisioning() const;
+
+    /** @brief @c true while the server is serving at reduced warm-up speed. */
+    bool isWarmingUp() const;
+
+    /**
+     * @brief Stops the server taking new work so it can be retired once
+     *        its active requests finish.
+     * @param now Current simulation cycle, kept for drainStartCycle().
      */
-    bool processTick();
+    void drain(int now);
+
+    /** @brief @c true once drain() has been called. */
+    bool isDraining() const;
+
+    /** @brief Cycle drain() was called, or -1 if the server is not draining. */
+    int drainStartCycle() const;
 
     /**
-     * @brief Checks whether this server is currently idle.
-     * @return @c true when no request is being processed.
+     * @brief Checks whether this server can accept another request.
+     * @return @c true when the server is neither provisioning nor draining
+     *         and at least one slot is free.
      */
     bool isAvailable() const;
 
+    /**
+     * @brief Returns the number of requests currently being processed.
+     * @return Active request count in [0, slotCount()].
+     */
+    int activeRequests() const;
+
+    /**
+     * @brief Returns the number of concurrency slots.
+     * @return Slot count set at construction time.
+     */
+    int slotCount() const;
+
+    /**
+     * @brief Returns the service mode.
+     * @return ServiceMode set at construction time.
+     */
+    ServiceMode mode() const;
+
+    /** @brief Work units processed per cycle per slot. */
+    double speed() const;
+
+    /** @brief Index of this server's type in Config::serverTypes. */
+    int typeIndex() const;
+
+    /**
+     * @brief Returns the requests this server can work through per cycle at
+     *        full load, in units of one speed-1 slot.
+     * @return slots × speed for FCFS; speed for processor sharing.
+     */
+    double serviceRate() const;
+
+    /** @brief Cycles this server has been ticked since it was created. */
+    long long lifetimeTicks() const;
+
+    /**
+     * @brief Busy time accumulated since creation, in cycles.
+     *
+     * Each tick adds the fraction of slots in use (FCFS) or 1 whenever any
+     * request is active (processor sharing), so busyTime() / lifetimeTicks()
+     * is the server's utilization.
+     */
+    double busyTime() const;
+
+    /**
+     * @brief Returns the cycles of work still outstanding, summed over all
+     *        active requests.
+     * @return Remaining work rounded up to whole speed-1 cycles, or 0 when idle.
+     */
+    int remainingWork() const;
+
+    /**
+     * @brief Returns the work-unit clock that finish tags are measured against.
+     *
+     * A request accepted with @c t units of work has @c t units left when
+     * accepted and @c tag-workClock() units left later; the clock restarts
+     * at 0 only once the server is empty.
+     */
+    double workClock() const;
+
     /**
      * @brief Returns the unique identifier string for this server.
      * @return Server ID string set at construction time.
@@ -77,11 +242,24 @@ public:
     int completedCount() const;
 
 private:
-    std::string serverId;      ///< Unique identifier for this server instance.
-    bool isBusy;               ///< @c true while a request is being processed.
-    int remainingTime;         ///< Clock cycles left until the current request finishes.
-    Request* currentRequest;   ///< Pointer to the request currently being handled.
-    int completedRequests;     ///< Running total of requests finished by this server.
+    std::string serverId;           ///< Unique identifier for this server instance.
+    int slotLimit;                  ///< Maximum concurrent requests.
+    ServiceMode serviceMode;        ///< FCFS per slot or processor sharing.
+    double speedFactor;             ///< Work units per cycle per slot.
+    int serverType;                 ///< Index into Config::serverTypes.
+    long long ticks;                ///< processTick() calls since creation.
+    double busy;                    ///< Accumulated busy time (see busyTime()).
+    double clock;                   ///< Work-unit clock; reset to 0 whenever the server empties.
+    std::vector<ActiveJob> jobs;    ///< Min-heap (by finishTag) of active requests.
+    double tagSum;                  ///< Sum of the jobs' finish tags, for remainingWork().
+    int completedRequests;          ///< Running total of requests finished by this server.
+    int bootLeft;                   ///< Provisioning ticks left; no work is accepted until 0.
+    int warmupTotal;                ///< Length of the warm-up ramp.
+    int warmupLeft;                 ///< Warm-up ticks left.
+    double warmupStart;             ///< Speed fraction at the start of the ramp.
+    int drainSince;                 ///< Cycle draining started, or -1.
+    ResponseCache* cache;           ///< Response cache, or @c nullptr.
+    double cacheHitFactor;          ///< Fraction of the work a cache hit still costs.
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,92 @@
+// WorkerPool.cpp
+
+#include "WorkerPool.h"
+
+// spawn the background workers, the caller is worker 0
+WorkerPool::WorkerPool(int threadCount) {
+    current = nullptr;
+    currentTaskCount = 0;
+    generation = 0;
+    pendingWorkers = 0;
+    stopping = false;
+    workerCount = threadCount < 1 ? 1 : threadCount;
+
+    for (int worker = 1; worker < workerCount; worker++) {
+        threads.push_back(std::thread(&WorkerPool::workerLoop, this, worker));
+    }
+}
+
+// tell every worker to stop and wait for them
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    startSignal.notify_all();
+
+    for (int i = 0; i < (int)threads.size(); i++) {
+        threads[i].join();
+    }
+}
+
+// post a batch, do our own share, then wait for the rest
+void WorkerPool::run(int taskCount, const std::function<void(int)>& task) {
+    if (workerCount == 1) {
+        for (int i = 0; i < taskCount; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        current = &task;
+        currentTaskCount = taskCount;
+        pendingWorkers = workerCount - 1;
+        generation++;
+    }
+    startSignal.notify_all();
+
+    runShare(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    doneSignal.wait(lock, [this] { return pendingWorkers == 0; });
+    current = nullptr;
+}
+
+// getter for the number of workers
+int WorkerPool::size() const {
+    return workerCount;
+}
+
+// worker i runs tasks i, i + N, i + 2N, ...
+void WorkerPool::runShare(int worker) {
+    for (int i = worker; i < currentTaskCount; i += workerCount) {
+        (*current)(i);
+    }
+}
+
+// wait for a batch, run our share, report back
+void WorkerPool::workerLoop(int worker) {
+    long long seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            startSignal.wait(lock, [this, seen] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+        }
+
+        runShare(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pendingWorkers--;
+            if (pendingWorkers == 0) {
+                doneSignal.notify_one();
+            }
+        }
+    }
+}
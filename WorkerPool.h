@@ -0,0 +1,81 @@
+/**
+ * @file WorkerPool.h
+ * @brief Defines the WorkerPool class, a small fork-join thread pool used to
+ *        tick simulation shards in parallel.
+ *
+ * @author Karan Bhagat
+ * @date 2026
+ */
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class WorkerPool
+ * @brief Fixed-size pool of threads that execute one batch of indexed tasks
+ *        at a time and then wait for the next batch.
+ *
+ * The calling thread acts as worker 0, so a pool built with one thread
+ * spawns nothing and simply runs every task inline. Task @c i of a batch is
+ * always executed by worker @c i @c % @c threadCount, which keeps the
+ * task-to-thread mapping stable from one batch to the next.
+ */
+class WorkerPool {
+public:
+    /**
+     * @brief Starts @p threadCount - 1 background threads.
+     * @param threadCount Total number of workers including the caller (minimum 1).
+     */
+    WorkerPool(int threadCount);
+
+    /**
+     * @brief Destructor. Signals all background threads to exit and joins them.
+     */
+    ~WorkerPool();
+
+    /**
+     * @brief Runs @p task for every index in [0, taskCount) and blocks until
+     *        all of them have finished.
+     * @param taskCount Number of tasks in this batch.
+     * @param task      Callable invoked with the task index.
+     */
+    void run(int taskCount, const std::function<void(int)>& task);
+
+    /**
+     * @brief Returns the number of workers, including the calling thread.
+     * @return Worker count set at construction time.
+     */
+    int size() const;
+
+private:
+    std::vector<std::thread> threads;        ///< Background workers 1..N-1.
+    std::mutex mutex;                        ///< Guards all fields below.
+    std::condition_variable startSignal;     ///< Wakes workers when a batch is posted.
+    std::condition_variable doneSignal;      ///< Wakes the caller when all workers finish.
+    const std::function<void(int)>* current; ///< Task of the batch in flight.
+    int currentTaskCount;                    ///< Number of tasks in the batch in flight.
+    long long generation;                    ///< Incremented once per posted batch.
+    int pendingWorkers;                      ///< Background workers still busy with the batch.
+    bool stopping;                           ///< Set by the destructor to end the workers.
+    int workerCount;                         ///< Total workers including the caller.
+
+    /**
+     * @brief Executes the tasks owned by one worker for the current batch.
+     * @param worker Worker index in [0, workerCount).
+     */
+    void runShare(int worker);
+
+    /**
+     * @brief Main loop of each background thread.
+     * @param worker Worker index in [1, workerCount).
+     */
+    void workerLoop(int worker);
+};
+
+#endif
@@ -20,8 +20,29 @@
  * @section classes Classes
  * - **LoadBalancer** – orchestrates the simulation; owns the server pool,
  *   request queue, scaling logic, and log output.
- * - **WebServer** – models one backend server; handles one request at a time
- *   and counts down its processing timer each clock cycle.
+ * - **Shard** – one partition of the server pool and queue; shards are
+ *   ticked in parallel when more than one worker thread is configured.
+ * - **WorkerPool** – fork-join thread pool that runs the shards each cycle.
+ * - **DispatchPolicy** – pluggable server selection (first idle, round robin,
+ *   least outstanding, JSQ, power-of-d choices, least work left, and
+ *   Maglev or jump-hash client affinity).
+ * - **ResponseCache** – optional per-server LRU or TinyLFU cache; a hit
+ *   shortens the request, so affinity routing pays off.
+ * - **FairQueue** – per-job-type lanes (P and S) shared by deficit round
+ *   robin with configurable weights.
+ * - **RequestQueue** – a shard's pending requests, served FIFO or by size
+ *   (SJF, preemptive SRPT, or size intervals).
+ * - **AdmissionControl / CoDelController** – bounded queue with drop-tail,
+ *   drop-oldest, RED or CoDel load shedding.
+ * - **ScalingPolicy** – pluggable autoscaler (queue thresholds with single
+ *   or proportional steps, a predictive policy sized from forecast arrivals, or a PID controller
+ *   holding p95 queue wait at an SLO).
+ * - **Histogram** – constant-memory, log-bucketed (HDR-style) mergeable
+ *   histogram behind the wait, service and response time reports.
+ * - **RequestPipeline** – optional generate/filter/dispatch pipeline whose
+ *   stages are connected by lock-free SpscRing buffers.
+ * - **WebServer** – models one backend server with a configurable number of
+ *   concurrency slots, run either FCFS per slot or processor sharing.
  * - **Request** – plain data struct representing one web request (source/dest
  *   IPs, job type, processing time).
  * - **IPBlocker** – firewall that rejects requests whose source IP falls
@@ -39,9 +60,16 @@
 #include <iostream>
 #include <cstdlib>
 #include <string>
+#include "AsyncLogger.h"
 #include "Config.h"
+#include "DispatchPolicy.h"
+#include "FairQueue.h"
 #include "IPBlocker.h"
 #include "LoadBalancer.h"
+#include "LoadShedding.h"
+#include "RequestQueue.h"
+#include "ResponseCache.h"
+#include "ScalingPolicy.h"
 
 /**
  * @brief Prompts the user to enter a new integer value, keeping the
@@ -88,6 +116,52 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    if (!DispatchPolicy::isKnown(config.dispatchPolicy)) {
+        std::cerr << "[WARN] Unknown dispatch policy, using first_idle: " << config.dispatchPolicy << '\n';
+        config.dispatchPolicy = "first_idle";
+    }
+
+    if (!ScalingPolicy::isKnown(config.scalingPolicy)) {
+        std::cerr << "[WARN] Unknown scaling policy, using threshold: " << config.scalingPolicy << '\n';
+        config.scalingPolicy = "threshold";
+    }
+
+    ShedPolicy shedPolicy;
+    if (!AdmissionControl::parsePolicy(config.shedPolicy, shedPolicy)) {
+        std::cerr << "[WARN] Unknown shed policy, using drop_tail: " << config.shedPolicy << '\n';
+        config.shedPolicy = "drop_tail";
+    }
+
+    LogLevel logLevel;
+    if (!AsyncLogger::parseLevel(config.logLevel, logLevel)) {
+        std::cerr << "[WARN] Unknown log level, using trace: " << config.logLevel << '\n';
+        config.logLevel = "trace";
+    }
+
+    LogLevel consoleLevel;
+    if (!AsyncLogger::parseLevel(config.consoleLevel, consoleLevel)) {
+        std::cerr << "[WARN] Unknown console level, using request: " << config.consoleLevel << '\n';
+        config.consoleLevel = "request";
+    }
+
+    LogOverflow logOverflow;
+    if (!AsyncLogger::parseOverflow(config.logOverflow, logOverflow)) {
+        std::cerr << "[WARN] Unknown log overflow policy, using block: " << config.logOverflow << '\n';
+        config.logOverflow = "block";
+    }
+
+    CachePolicy cachePolicy;
+    if (!ResponseCache::parsePolicy(config.cachePolicy, cachePolicy)) {
+        std::cerr << "[WARN] Unknown cache policy, using none: " << config.cachePolicy << '\n';
+        config.cachePolicy = "none";
+    }
+
+    QueueDiscipline discipline;
+    if (!RequestQueue::parseDiscipline(config.queueDiscipline, discipline)) {
+        std::cerr << "[WARN] Unknown queue discipline, using fifo: " << config.queueDiscipline << '\n';
+        config.queueDiscipline = "fifo";
+    }
+
     std::cout << "[INFO] Config loaded from: " << configPath << '\n' << "\n";
 
     LoadBalancer balancer(config, blocker);
@@ -102,7 +176,92 @@ int main(int argc, char* argv[]) {
     std::cout << "Final queue size   : " << stats.finalQueueSize << '\n';
     std::cout << "Servers added      : " << stats.addedServers << '\n';
     std::cout << "Servers removed    : " << stats.removedServers << '\n';
+    std::cout << "Scale events       : up=" << stats.scaleUpEvents << " down=" << stats.scaleDownEvents << '\n';
     std::cout << "Final server count : " << stats.finalServerCount << '\n';
+    std::cout << "Scaling policy     : " << stats.scalingPolicy << '\n';
+    std::cout << "Scale-down blocked : " << stats.scaleDownBlocked << " events, " << stats.scaleDownShortfall << " servers short of idle\n";
+    if (config.scaleDownDrain) {
+        std::cout << "Drained servers    : " << stats.drainedServers << " (drain cycles mean=" << stats.drainTimes.mean() << " p99=" << stats.drainTimes.percentile(99) << " max=" << stats.drainTimes.max() << ", still draining=" << stats.finalDrainingServers << ")\n";
+    }
+    std::cout << "Server cycles      : " << stats.serverCycles << '\n';
+    if (config.serverBootCycles > 0 || config.serverWarmupCycles > 0) {
+        std::cout << "Cold start         : provisioning=" << stats.provisioningCycles << " warm-up=" << stats.warmupCycles << " server-cycles, pending at end=" << stats.finalPendingServers << '\n';
+    }
+    std::cout << "Dispatch policy    : " << stats.dispatchPolicy << '\n';
+    if (stats.affinity.lookups > 0) {
+        const AffinityStats& affinity = stats.affinity;
+        std::cout << "Affinity           : fallbacks=" << affinity.fallbacks << "/" << affinity.lookups << " (" << 100.0 * affinity.fallbacks / affinity.lookups << "%) rebuilds=" << affinity.rebuilds << " (" << affinity.rebuildSeconds * 1000 << " ms) remapped mean=" << (affinity.rebuilds > 0 ? 100.0 * affinity.remappedSum / affinity.rebuilds : 0.0) << "% max=" << 100.0 * affinity.maxRemapped << "%\n";
+    }
+    if (stats.cacheLookups > 0) {
+        std::cout << "Cache hit rate     : " << 100.0 * stats.cacheHits / stats.cacheLookups << "% (" << stats.cacheHits << "/" << stats.cacheLookups << ", " << stats.cachePolicy << " x" << config.cacheCapacity << " per server, dispatch " << stats.dispatchPolicy << ")\n";
+    }
+    for (int t = 0; !config.serverTypes.empty() && t < (int)stats.serverTypes.size(); t++) {
+        const ServerTypeStats& typeStats = stats.serverTypes[t];
+        std::cout << "Type " << typeStats.name << " (speed " << typeStats.speed << ") : final=" << typeStats.finalServers << " added=" << typeStats.addedServers << " removed=" << typeStats.removedServers << " completed=" << typeStats.completed << " utilization=" << (int)(typeStats.utilization() * 100) << "%\n";
+    }
+    const ServerLoadStats& load = stats.serverLoad;
+    std::cout << "Server utilization : mean=" << (int)(load.meanUtilization() * 100) << "% min=" << (int)(load.minUtilization * 100) << "% p50=" << load.utilization.percentile(50) / 10 << "% p90=" << load.utilization.percentile(90) / 10 << "% max=" << (int)(load.maxUtilization * 100) << "% (" << load.servers << " servers, hottest " << load.hottest << ")\n";
+    std::cout << "Load imbalance     : jain=" << load.jainIndex() << " utilization max/mean=" << load.utilizationImbalance() << " completions max/mean=" << load.completionImbalance() << '\n';
+    std::cout << "Queue discipline   : " << stats.queueDiscipline << '\n';
+    const char* latencyNames[] = {"Queue wait (cycles): ", "Service (cycles)   : ", "Response (cycles)  : "};
+    const Histogram* latencies[] = {&stats.waitTimes, &stats.serviceTimes, &stats.responseTimes};
+    for (int k = 0; k < 3; k++) {
+        const Histogram& h = *latencies[k];
+        std::cout << latencyNames[k] << "mean=" << h.mean() << " p50=" << h.percentile(50) << " p90=" << h.percentile(90) << " p99=" << h.percentile(99) << " p99.9=" << h.percentile(99.9) << " max=" << h.max() << '\n';
+    }
+    for (int lane = 0; lane < FairQueue::LANE_COUNT; lane++) {
+        const Histogram& wait = stats.jobTypeWaits[lane];
+        const Histogram& response = stats.jobTypeResponses[lane];
+        std::cout << "Job type " << (lane == 0 ? 'P' : 'S');
+        if (stats.fairQueueing) {
+            std::cout << " (weight " << config.jobTypeWeights[lane] << ")";
+        }
+        std::cout << " : wait mean=" << wait.mean() << " p99=" << wait.percentile(99) << " | response mean=" << response.mean() << " p99=" << response.percentile(99) << " | completed=" << response.count() << '\n';
+    }
+    if (stats.queueDiscipline == "srpt") {
+        std::cout << "Preemptions        : " << stats.preemptions << '\n';
+    }
+    if (config.queueCapacity > 0 || stats.shedPolicy == "codel" || stats.shedRequests() > 0) {
+        std::cout << "Shed requests      : " << stats.shedRequests() << " (" << stats.shedPolicy << ": full=" << stats.shedFull << " oldest=" << stats.shedOldest << " early=" << stats.shedEarly << " codel=" << stats.shedCoDel << ")\n";
+    }
+    if (config.requestTimeout > 0) {
+        std::cout << "Timed out requests : " << stats.timedOutRequests << '\n';
+        std::cout << "Late completions   : " << stats.lateCompletions << '\n';
+        std::cout << "Goodput            : " << stats.goodput << " requests/cycle\n";
+    }
+    if (stats.workerThreads > 1) {
+        std::cout << "Worker threads     : " << stats.workerThreads << '\n';
+        std::cout << "Stolen requests    : " << stats.stolenRequests << '\n';
+    }
+    if (stats.pipelined) {
+        int bottleneck = 0;
+        for (int i = 0; i < RequestPipeline::STAGE_COUNT; i++) {
+            const StageStats& stage = stats.pipelineStages[i];
+            std::cout << "Stage " << RequestPipeline::stageName(i) << " utilization : " << (int)(stage.utilization() * 100) << "% (busy " << stage.busySeconds << " s, waiting on input " << stage.inputWaitSeconds << " s, on output " << stage.outputWaitSeconds << " s)\n";
+            if (stage.utilization() > stats.pipelineStages[bottleneck].utilization()) {
+                bottleneck = i;
+            }
+        }
+        std::cout << "Pipeline bottleneck: " << RequestPipeline::stageName(bottleneck) << '\n';
+    }
+    if (stats.asyncLog) {
+        std::cout << "Async log          : records=" << stats.logRecords << " dropped=" << stats.logDropped << " stalls=" << stats.logStalls << " writes=" << stats.logWrites << " (" << config.logOverflow << ", ring " << config.logRingSize << ")\n";
+    }
+    if (!config.logFilePath.empty()) {
+        std::cout << "Log volume         : " << stats.logBytes << " bytes (" << (stats.generatedRequests > 0 ? (double)stats.logBytes / stats.generatedRequests : 0.0) << " bytes/request, " << config.logFormat << ")\n";
+    }
+    if (stats.timeseriesRows > 0) {
+        std::cout << "Time series        : " << stats.timeseriesRows << " rows x " << stats.timeseriesWindow << " cycles -> " << config.timeseriesFile << " (" << config.timeseriesFormat << ")\n";
+    }
+    if (stats.metricsEndpoint) {
+        std::cout << "Metrics endpoint   : http://127.0.0.1:" << config.metricsPort << " (" << stats.metricsSnapshots << " snapshots, " << stats.metricsScrapes << " scrapes)\n";
+    }
+    std::cout << "Console            : " << stats.consoleLines << " lines, " << stats.consoleSuppressed << " suppressed (" << config.consoleLevel << ", " << config.consoleBurst << " per tag per " << config.consoleWindow << " cycles)\n";
+    std::cout << "Wall time          : " << stats.wallSeconds << " s";
+    if (stats.wallSeconds > 0.0) {
+        std::cout << " (" << (long long)(config.simulationCycles / stats.wallSeconds) << " cycles/s)";
+    }
+    std::cout << '\n';
     std::cout << "Log file           : " << config.logFilePath << '\n';
 
     return 0;